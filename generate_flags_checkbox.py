@@ -14,6 +14,7 @@ def all_flags():
         "ImGG::Flag::NoColorEdit":                ["isNoColorEdit"],
         "ImGG::Flag::NoDragDownToDelete":         ["isNoDragDownToDelete"],
         "ImGG::Flag::NoBorder":                   ["isNoBorder"],
+        "ImGG::Flag::NoMidpointSlider":           ["isNoMidpointSlider"],
         "ImGG::Flag::NoAddAndRemoveButtons":      ["isNoAddAndRemoveButtons"],
         "ImGG::Flag::NoMarkOptions":              ["isNoMarkOptions"],
     }
@@ -75,6 +75,13 @@ auto checkboxes_for_all_flags() -> ImGG::Flags
         options |= ImGG::Flag::NoBorder;
     }
 
+    static auto isNoMidpointSlider = false;
+    ImGui::Checkbox("ImGG::Flag::NoMidpointSlider", &isNoMidpointSlider);
+    if (isNoMidpointSlider)
+    {
+        options |= ImGG::Flag::NoMidpointSlider;
+    }
+
     static auto isNoAddAndRemoveButtons = false;
     ImGui::Checkbox("ImGG::Flag::NoAddAndRemoveButtons", &isNoAddAndRemoveButtons);
     if (isNoAddAndRemoveButtons)
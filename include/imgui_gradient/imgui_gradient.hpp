@@ -1,4 +1,17 @@
 #pragma once
 
+#include "../src/CompactGradient.hpp"
+#include "../src/EasedInterpolation.hpp"
+#include "../src/FixedPointGradient.hpp"
+#include "../src/GradientAtlas.hpp"
+#include "../src/GradientCursor.hpp"
 #include "../src/GradientWidget.hpp"
+#include "../src/IntegerColormap.hpp"
+#include "../src/InverseColormap.hpp"
+#include "../src/KeyframedGradient.hpp"
+#include "../src/PackedGradients.hpp"
+#include "../src/StepGradient.hpp"
+#include "../src/TypedGradient.hpp"
+#include "../src/bake_size.hpp"
+#include "../src/colormap.hpp"
 #include "../src/extra_widgets.hpp"
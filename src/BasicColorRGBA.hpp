@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include "ColorRGBA.hpp"
+
+namespace ImGG {
+
+/// A color whose channels are stored as `Channel`s.
+/// Floating point channels go from 0 to 1, and integer channels go from 0 to their maximum value (e.g. 255 for `uint8_t`).
+template<typename Channel>
+struct BasicColorRGBA {
+    Channel r;
+    Channel g;
+    Channel b;
+    Channel a;
+
+    friend auto operator==(const BasicColorRGBA& x, const BasicColorRGBA& y) -> bool
+    {
+        return x.r == y.r
+               && x.g == y.g
+               && x.b == y.b
+               && x.a == y.a;
+    }
+    friend auto operator!=(const BasicColorRGBA& x, const BasicColorRGBA& y) -> bool { return !(x == y); }
+};
+
+using ColorRGBA8  = BasicColorRGBA<uint8_t>;
+using ColorRGBA16 = BasicColorRGBA<uint16_t>;
+using ColorRGBAf  = BasicColorRGBA<float>;
+using ColorRGBAd  = BasicColorRGBA<double>;
+
+namespace internal {
+
+template<typename Channel, bool is_integer = std::is_integral<Channel>::value>
+struct ChannelTraits;
+
+template<typename Channel>
+struct ChannelTraits<Channel, true> {
+    /// Same rounding as `ImGui::ColorConvertFloat4ToU32()`.
+    static auto from_float(float value) -> Channel
+    {
+        static constexpr float max = static_cast<float>(std::numeric_limits<Channel>::max());
+        return static_cast<Channel>((value < 0.f ? 0.f : value > 1.f ? 1.f : value) * max + 0.5f);
+    }
+
+    template<typename Scalar>
+    static auto lerp(Channel a, Channel b, Scalar t) -> Channel
+    {
+        return static_cast<Channel>(static_cast<Scalar>(a) + (static_cast<Scalar>(b) - static_cast<Scalar>(a)) * t + static_cast<Scalar>(0.5)); // Rounds to the closest value, because the result is never negative
+    }
+};
+
+template<typename Channel>
+struct ChannelTraits<Channel, false> {
+    static auto from_float(float value) -> Channel
+    {
+        return static_cast<Channel>(value);
+    }
+
+    template<typename Scalar>
+    static auto lerp(Channel a, Channel b, Scalar t) -> Channel
+    {
+        return static_cast<Channel>(a + (b - a) * static_cast<Channel>(t));
+    }
+};
+
+/// What the gradients need to know about a color type.
+template<typename Color>
+struct ColorTraits;
+
+template<typename Channel>
+struct ColorTraits<BasicColorRGBA<Channel>> {
+    using Color = BasicColorRGBA<Channel>;
+
+    static auto from_rgba(const ColorRGBA& color) -> Color
+    {
+        using Traits = ChannelTraits<Channel>;
+        return Color{Traits::from_float(color.x), Traits::from_float(color.y), Traits::from_float(color.z), Traits::from_float(color.w)};
+    }
+
+    template<typename Scalar>
+    static auto lerp(const Color& a, const Color& b, Scalar t) -> Color
+    {
+        using Traits = ChannelTraits<Channel>;
+        return Color{Traits::lerp(a.r, b.r, t), Traits::lerp(a.g, b.g, t), Traits::lerp(a.b, b.b, t), Traits::lerp(a.a, b.a, t)};
+    }
+};
+
+template<>
+struct ColorTraits<ColorRGBA> {
+    static auto from_rgba(const ColorRGBA& color) -> ColorRGBA
+    {
+        return color;
+    }
+
+    template<typename Scalar>
+    static auto lerp(const ColorRGBA& a, const ColorRGBA& b, Scalar t) -> ColorRGBA
+    {
+        const auto t_float = static_cast<float>(t);
+        return ColorRGBA{
+            a.x + (b.x - a.x) * t_float,
+            a.y + (b.y - a.y) * t_float,
+            a.z + (b.z - a.z) * t_float,
+            a.w + (b.w - a.w) * t_float,
+        };
+    }
+};
+
+} // namespace internal
+
+} // namespace ImGG
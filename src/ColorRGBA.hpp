@@ -14,4 +14,17 @@ inline auto operator==(const ColorRGBA& a, const ColorRGBA& b) -> bool
            && (a.w == b.w);
 }
 
+namespace internal {
+
+/// Same as `ImGui::ColorConvertFloat4ToU32()`, but can be inlined in the loops that pack a lot of colors.
+inline auto pack_rgba8(const ColorRGBA& color) -> ImU32
+{
+    const auto to_byte = [](float channel) {
+        return static_cast<ImU32>(static_cast<int>((channel < 0.f ? 0.f : channel > 1.f ? 1.f : channel) * 255.f + 0.5f));
+    };
+    return IM_COL32(to_byte(color.x), to_byte(color.y), to_byte(color.z), to_byte(color.w));
+}
+
+} // namespace internal
+
 } // namespace ImGG
\ No newline at end of file
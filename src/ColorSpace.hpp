@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef> // Includes size_t
+
+namespace ImGG {
+
+/// The color space in which the colors are interpolated between two marks.
+/// The colors of the marks, and the ones returned by the gradient, are always sRGB: this only changes the path that is taken between two marks.
+enum class ColorSpace : size_t { // We use size_t so that we can use the ColorSpace to index into an array
+    /// Interpolates the sRGB components directly, like `ImLerp()` does.
+    sRGB,
+    /// Interpolates the amount of light, which avoids the dark bands between saturated colors.
+    LinearRGB,
+    /// Interpolates in the perceptual OKLab space, so that the lightness and the hue change evenly. See https://bottosson.github.io/posts/oklab/.
+    OKLab,
+};
+
+} // namespace ImGG
@@ -0,0 +1,197 @@
+#include "CompactGradient.hpp"
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include "Gradient.hpp"
+#include "InterpolationPolicy.hpp"
+
+namespace ImGG {
+
+static_assert(sizeof(CompactMark) == 8, "CompactMark should not have any padding");
+
+static constexpr float max_position = 65535.f; // Same as `FixedPointGradient`
+static constexpr float max_midpoint = 65534.f; // Even, so that 0.5 is exactly representable
+
+/// Rounds `value`, clamped to [0, 1], to an integer between 0 and `max`.
+static auto quantize(float value, float max) -> uint32_t
+{
+    return static_cast<uint32_t>((value < 0.f ? 0.f : value > 1.f ? 1.f : value) * max + 0.5f);
+}
+
+static auto dequantize(uint32_t value, float max) -> float
+{
+    return static_cast<float>(value) / max;
+}
+
+/// The number of bits of each channel (red, green, blue, alpha).
+static auto channels_bits(CompactColorFormat color_format) -> const uint32_t*
+{
+    static constexpr uint32_t rgba8[]   = {8, 8, 8, 8};
+    static constexpr uint32_t rgb10a2[] = {10, 10, 10, 2};
+    switch (color_format)
+    {
+    case CompactColorFormat::RGBA8:
+        return rgba8;
+    case CompactColorFormat::RGB10A2:
+        return rgb10a2;
+    default:
+        assert(false && "[ImGuiGradient::channels_bits] Invalid enum value");
+        return rgba8;
+    }
+}
+
+static auto encode_color(const ColorRGBA& color, CompactColorFormat color_format) -> uint32_t
+{
+    const uint32_t* const bits     = channels_bits(color_format);
+    const float           values[] = {color.x, color.y, color.z, color.w};
+    uint32_t              result   = 0;
+    uint32_t              shift    = 0;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        result |= quantize(values[i], static_cast<float>((1u << bits[i]) - 1)) << shift;
+        shift += bits[i];
+    }
+    return result;
+}
+
+static auto decode_color(uint32_t color, CompactColorFormat color_format) -> ColorRGBA
+{
+    const uint32_t* const bits = channels_bits(color_format);
+    float                 values[4];
+    uint32_t              shift = 0;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        const uint32_t max = (1u << bits[i]) - 1;
+        values[i]          = dequantize((color >> shift) & max, static_cast<float>(max));
+        shift += bits[i];
+    }
+    return ColorRGBA{values[0], values[1], values[2], values[3]};
+}
+
+auto CompactGradient::encode(const Mark& mark, CompactColorFormat color_format) -> CompactMark
+{
+    return CompactMark{
+        FixedPointGradient::to_fixed_point(mark.position.get()),
+        static_cast<uint16_t>(quantize(mark.midpoint, max_midpoint)),
+        encode_color(mark.color, color_format),
+    };
+}
+
+auto CompactGradient::decode(const CompactMark& mark, CompactColorFormat color_format) -> Mark
+{
+    return Mark{
+        RelativePosition{dequantize(mark.position, max_position)},
+        decode_color(mark.color, color_format),
+        dequantize(mark.midpoint, max_midpoint),
+    };
+}
+
+static auto compact_marks(const Gradient& gradient, CompactColorFormat color_format) -> std::vector<CompactMark>
+{
+    std::vector<CompactMark> marks;
+    marks.reserve(gradient.get_marks().size());
+    for (const Mark& mark : gradient.get_marks())
+        marks.push_back(CompactGradient::encode(mark, color_format));
+    return marks;
+}
+
+CompactGradient::CompactGradient()
+    : CompactGradient{Gradient{}}
+{}
+
+CompactGradient::CompactGradient(const Gradient& gradient, CompactColorFormat color_format)
+    : CompactGradient{compact_marks(gradient, color_format), color_format, gradient.interpolation_mode(), gradient.color_space()}
+{}
+
+CompactGradient::CompactGradient(std::vector<CompactMark> marks, CompactColorFormat color_format, Interpolation interpolation_mode, ColorSpace color_space)
+    : _marks{std::move(marks)}
+    , _color_format{color_format}
+    , _interpolation_mode{interpolation_mode}
+    , _color_space{color_space}
+{
+    // Stable, like `Gradient`, so that the marks at the same position stay in the same order
+    std::stable_sort(_marks.begin(), _marks.end(), [](const CompactMark& a, const CompactMark& b) { return a.position < b.position; });
+}
+
+auto CompactGradient::to_gradient() const -> Gradient
+{
+    std::vector<Mark> marks;
+    marks.reserve(_marks.size());
+    for (size_t i = 0; i < _marks.size(); ++i)
+        marks.push_back(mark(i));
+    auto gradient                 = Gradient{marks};
+    gradient.interpolation_mode() = _interpolation_mode;
+    gradient.color_space()        = _color_space;
+    return gradient;
+}
+
+/// Same as `Gradient::at_impl()`, but only decodes the marks around `position`.
+template<typename InterpolationPolicy>
+auto CompactGradient::at_impl(const RelativePosition position) const -> ColorRGBA
+{
+    // Decoding the positions is monotonic, so we can compare with the decoded positions while searching the integer ones.
+    const auto upper = std::upper_bound(_marks.begin(), _marks.end(), position.get(), [](float pos, const CompactMark& mark) {
+        return pos < dequantize(mark.position, max_position);
+    });
+    const auto lower = std::lower_bound(_marks.begin(), upper, position.get(), [](const CompactMark& mark, float pos) {
+        return dequantize(mark.position, max_position) < pos;
+    });
+    // Same as in `Gradient::surrounding_marks()`: the first mark of each group of marks that share the same position.
+    const auto count       = static_cast<std::ptrdiff_t>(_marks.size());
+    const auto position_of = [&](std::ptrdiff_t index) { return _marks[static_cast<size_t>(index)].position; };
+    const auto group_begin = [&](std::ptrdiff_t index) {
+        while (index > 0 && position_of(index - 1) == position_of(index))
+            --index;
+        return index;
+    };
+    const auto group_end = [&](std::ptrdiff_t index) {
+        const auto group_position = position_of(index);
+        while (index < count && position_of(index) == group_position)
+            ++index;
+        return index;
+    };
+
+    Mark       decoded[4];
+    const auto decoded_at = [&](std::ptrdiff_t index, Mark& result) -> const Mark* {
+        if (index < 0 || index >= count)
+            return nullptr;
+        result = mark(static_cast<size_t>(index));
+        return &result;
+    };
+    const std::ptrdiff_t lower_index = lower != _marks.begin() ? group_begin(lower - _marks.begin() - 1) : -1;
+    const std::ptrdiff_t upper_index = upper - _marks.begin();
+    const auto           marks       = internal::SurroundingMarks{
+        decoded_at(lower_index, decoded[0]),
+        decoded_at(upper_index, decoded[1]),
+        decoded_at(lower_index > 0 ? group_begin(lower_index - 1) : -1, decoded[2]),
+        decoded_at(upper_index < count ? group_end(upper_index) : count, decoded[3]),
+    };
+    return internal::color_between<InterpolationPolicy>(marks, position, _color_space);
+}
+
+auto CompactGradient::at(const RelativePosition position) const -> ColorRGBA
+{
+    switch (_interpolation_mode)
+    {
+    case Interpolation::Linear:
+        return at_impl<internal::InterpolationPolicy<Interpolation::Linear>>(position);
+
+    case Interpolation::Constant:
+        return at_impl<internal::InterpolationPolicy<Interpolation::Constant>>(position);
+
+    case Interpolation::Cubic:
+        return at_impl<internal::InterpolationPolicy<Interpolation::Cubic>>(position);
+
+    default:
+        assert(false && "[ImGuiGradient::CompactGradient::at] Invalid enum value");
+        return {-1.f, -1.f, -1.f, -1.f};
+    }
+}
+
+void CompactGradient::sample(const float* positions, ColorRGBA* colors, size_t count, WrapMode wrap_mode) const
+{
+    for (size_t i = 0; i < count; ++i)
+        colors[i] = at(RelativePosition{positions[i], wrap_mode});
+}
+
+} // namespace ImGG
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ColorRGBA.hpp"
+#include "ColorSpace.hpp"
+#include "FixedPointGradient.hpp"
+#include "Interpolation.hpp"
+#include "Mark.hpp"
+#include "RelativePosition.hpp"
+#include "WrapMode.hpp"
+
+namespace ImGG {
+
+class Gradient;
+
+/// How a `CompactMark` stores its color on 32 bits.
+enum class CompactColorFormat {
+    RGBA8,   // 8 bits per channel
+    RGB10A2, // 10 bits for red, green and blue, and 2 bits for alpha: smoother colors, for gradients that are opaque or almost
+};
+
+/// A `Mark` stored on 8 bytes instead of 24.
+struct CompactMark {
+    FixedPointPosition position; // 0 is the beginning of the gradient and 65535 is the end
+    uint16_t           midpoint; // From 0 to 65534, so that 0.5 (32767) is exact
+    uint32_t           color;    // In the `CompactColorFormat` of the gradient: red in the lowest bits, alpha in the highest ones
+
+    friend auto operator==(const CompactMark& a, const CompactMark& b) -> bool
+    {
+        return a.position == b.position
+               && a.midpoint == b.midpoint
+               && a.color == b.color;
+    }
+};
+
+/// A gradient whose marks are stored as `CompactMark`s, e.g. to keep a big library of gradients in memory.
+/// Converting a `Gradient` rounds its positions, midpoints and colors, but converting back with `to_gradient()` is exact:
+/// `CompactGradient{compact.to_gradient(), compact.color_format()} == compact`.
+/// It can be sampled without converting it: `at()` gives exactly the same colors as `to_gradient().at()`.
+class CompactGradient {
+public:
+    /// Black to white, like a default `Gradient`.
+    CompactGradient();
+    /// Rounds the positions and the midpoints of the marks to 16 bits, and their colors to `color_format`. The colors are clamped to [0, 1].
+    explicit CompactGradient(const Gradient&, CompactColorFormat color_format = CompactColorFormat::RGBA8);
+    /// The `marks` don't need to be sorted.
+    CompactGradient(std::vector<CompactMark> marks, CompactColorFormat color_format, Interpolation interpolation_mode, ColorSpace color_space = ColorSpace::sRGB);
+
+    auto to_gradient() const -> Gradient;
+
+    auto at(RelativePosition) const -> ColorRGBA;
+    /// Samples the gradient at `count` `positions`, and writes the results in `colors`.
+    /// `positions` can be outside of the [0, 1] range, they are mapped back into it according to `wrap_mode`.
+    void sample(const float* positions, ColorRGBA* colors, size_t count, WrapMode wrap_mode) const;
+
+    /// Sorted by position.
+    auto marks() const -> const std::vector<CompactMark>& { return _marks; }
+    /// The mark `index` of `marks()`, as it is in `to_gradient()`.
+    auto mark(size_t index) const -> Mark { return decode(_marks[index], _color_format); }
+    auto color_format() const -> CompactColorFormat { return _color_format; }
+    auto interpolation_mode() const -> Interpolation { return _interpolation_mode; }
+    auto color_space() const -> ColorSpace { return _color_space; }
+
+    static auto encode(const Mark&, CompactColorFormat) -> CompactMark;
+    static auto decode(const CompactMark&, CompactColorFormat) -> Mark;
+
+    friend auto operator==(const CompactGradient& a, const CompactGradient& b) -> bool
+    {
+        return a._marks == b._marks
+               && a._color_format == b._color_format
+               && a._interpolation_mode == b._interpolation_mode
+               && a._color_space == b._color_space;
+    }
+
+private:
+    template<typename InterpolationPolicy>
+    auto at_impl(RelativePosition position) const -> ColorRGBA;
+
+private:
+    std::vector<CompactMark> _marks{};
+    CompactColorFormat       _color_format{CompactColorFormat::RGBA8};
+    Interpolation            _interpolation_mode{Interpolation::Linear};
+    ColorSpace               _color_space{ColorSpace::sRGB};
+};
+
+} // namespace ImGG
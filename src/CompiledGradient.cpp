@@ -0,0 +1,299 @@
+#include "CompiledGradient.hpp"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include "Gradient.hpp"
+#include "color_conversions.hpp"
+#include "half_float.hpp"
+#include "sample_kernels.hpp"
+
+namespace ImGG {
+
+CompiledGradient::CompiledGradient()
+    : _segments(1) // An empty gradient is black everywhere
+{}
+
+static auto uniform_segment(const ColorRGBA& color) -> internal::Segment
+{
+    auto segment  = internal::Segment{};
+    segment.color = color;
+    return segment;
+}
+
+/// The tangents are only used by `Interpolation::Cubic`.
+static auto interpolated_segment(const Mark& lower, const Mark& upper, const ColorRGBA& lower_tangent, const ColorRGBA& upper_tangent, Interpolation interpolation_mode) -> internal::Segment
+{
+    switch (interpolation_mode)
+    {
+    case Interpolation::Linear:
+    {
+        auto segment          = internal::Segment{};
+        segment.start         = lower.position.get();
+        segment.inverse_width = 1.f / (upper.position.get() - lower.position.get());
+        segment.bias          = internal::MidpointBias{upper.midpoint};
+        segment.color         = lower.color;
+        segment.slope         = ColorRGBA{
+            upper.color.x - lower.color.x,
+            upper.color.y - lower.color.y,
+            upper.color.z - lower.color.z,
+            upper.color.w - lower.color.w,
+        };
+        return segment;
+    }
+
+    case Interpolation::Constant:
+    {
+        return uniform_segment(upper.color);
+    }
+
+    case Interpolation::Cubic:
+    {
+        return internal::InterpolationPolicy<Interpolation::Cubic>::segment(lower, upper, lower_tangent, upper_tangent);
+    }
+
+    default:
+        assert(false && "[ImGuiGradient::interpolated_segment] Invalid enum value");
+        return uniform_segment({-1.f, -1.f, -1.f, -1.f});
+    }
+}
+
+static auto scaled(const ColorRGBA& color, float factor) -> ColorRGBA
+{
+    return ColorRGBA{color.x * factor, color.y * factor, color.z * factor, color.w * factor};
+}
+
+static auto sum(const ColorRGBA& a, const ColorRGBA& b) -> ColorRGBA
+{
+    return ColorRGBA{a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w};
+}
+
+/// The integral of `segment` between `begin` and `end`.
+/// The segments are polynomials of degree 3 at most, so Simpson's rule gives the exact integral.
+/// When the segment has a midpoint, it is no longer a polynomial of the position, so we cut it into pieces that Simpson's rule approximates well.
+static auto segment_integral(const internal::Segment& segment, float begin, float end) -> ColorRGBA
+{
+    using Cubic                             = internal::InterpolationPolicy<Interpolation::Cubic>;
+    static constexpr int pieces_when_biased = 32;
+
+    const int pieces = segment.bias.slope == 0.f ? 1 : pieces_when_biased;
+    auto      total  = ColorRGBA{0.f, 0.f, 0.f, 0.f};
+    for (int piece = 0; piece < pieces; ++piece)
+    {
+        const float piece_begin = begin + (end - begin) * static_cast<float>(piece) / static_cast<float>(pieces);
+        const float piece_end   = piece == pieces - 1 ? end : begin + (end - begin) * static_cast<float>(piece + 1) / static_cast<float>(pieces);
+        total                   = sum(total, scaled(sum(sum(Cubic::segment_color(segment, piece_begin), Cubic::segment_color(segment, piece_end)),
+                                                        scaled(Cubic::segment_color(segment, (piece_begin + piece_end) * 0.5f), 4.f)),
+                                                    (piece_end - piece_begin) / 6.f));
+    }
+    return total;
+}
+
+CompiledGradient::CompiledGradient(const Gradient& gradient)
+    : _interpolation_mode{gradient.interpolation_mode()}
+    , _color_space{gradient.color_space()}
+{
+    // When several marks share the same position, only the first one is ever used by `Gradient::at()`.
+    // All the colors are converted to the interpolation color space once and for all, so that sampling only needs to convert its result.
+    std::vector<Mark> marks;
+    marks.reserve(gradient.get_marks().size());
+    for (const Mark& mark : gradient.get_marks())
+    {
+        if (marks.empty() || marks.back().position != mark.position)
+        {
+            marks.push_back(Mark{mark.position, internal::to_color_space(mark.color, _color_space), mark.midpoint});
+        }
+    }
+
+    std::vector<ColorRGBA> tangents(marks.size(), ColorRGBA{0.f, 0.f, 0.f, 0.f});
+    if (_interpolation_mode == Interpolation::Cubic)
+    {
+        for (size_t i = 0; i < marks.size(); ++i)
+        {
+            tangents[i] = internal::InterpolationPolicy<Interpolation::Cubic>::tangent(
+                i == 0 ? nullptr : &marks[i - 1],
+                marks[i],
+                i + 1 == marks.size() ? nullptr : &marks[i + 1]
+            );
+        }
+    }
+
+    _positions.reserve(marks.size());
+    _colors_on_marks.reserve(marks.size());
+    _segments.reserve(marks.size() + 1);
+    for (size_t i = 0; i < marks.size(); ++i)
+    {
+        _positions.push_back(marks[i].position.get());
+        _colors_on_marks.push_back(internal::to_color_space(gradient.at(marks[i].position), _color_space)); // Sampling exactly on a mark has a few special cases, so we simply ask the gradient.
+        _segments.push_back(i == 0
+                                ? uniform_segment(marks[i].color)
+                                : interpolated_segment(marks[i - 1], marks[i], tangents[i - 1], tangents[i], _interpolation_mode));
+    }
+    _segments.push_back(marks.empty()
+                            ? uniform_segment(internal::to_color_space({0.f, 0.f, 0.f, 1.f}, _color_space))
+                            : uniform_segment(marks.back().color));
+
+    _integrals.reserve(_positions.size());
+    for (size_t i = 0; i < _positions.size(); ++i)
+    {
+        const float begin = i == 0 ? 0.f : _positions[i - 1];
+        _integrals.push_back(sum(i == 0 ? ColorRGBA{0.f, 0.f, 0.f, 0.f} : _integrals[i - 1],
+                                 segment_integral(_segments[i], begin, _positions[i])));
+    }
+}
+
+auto CompiledGradient::sampling_data() const -> internal::SamplingData
+{
+    auto data            = internal::SamplingData{};
+    data.positions       = _positions.data();
+    data.positions_count = _positions.size();
+    data.colors_on_marks = _colors_on_marks.data();
+    data.segments        = _segments.data();
+    data.color_space     = _color_space;
+    return data;
+}
+
+auto CompiledGradient::at(const RelativePosition position) const -> ColorRGBA
+{
+    return internal::from_color_space(color_in_color_space(position.get()), _color_space);
+}
+
+auto CompiledGradient::color_in_color_space(const float position) const -> ColorRGBA
+{
+    const auto data = sampling_data();
+    return internal::color_at(data, internal::segment_index(data, position), position);
+}
+
+auto CompiledGradient::integral(const float begin, const float end) const -> ColorRGBA
+{
+    const auto   data        = sampling_data();
+    const size_t begin_index = internal::segment_index(data, begin);
+    const size_t end_index   = internal::segment_index(data, end);
+    if (begin_index == end_index)
+        return segment_integral(_segments[begin_index], begin, end);
+
+    // Integrate the partial segments at both ends directly, instead of subtracting the integrals from 0,
+    // so that we don't lose precision on small intervals.
+    return sum(sum(segment_integral(_segments[begin_index], begin, _positions[begin_index]),
+                   sum(_integrals[end_index - 1], scaled(_integrals[begin_index], -1.f))),
+               segment_integral(_segments[end_index], _positions[end_index - 1], end));
+}
+
+auto CompiledGradient::average(float a, float b, const WrapMode wrap_mode) const -> ColorRGBA
+{
+    if (a > b)
+        std::swap(a, b);
+    if (a == b)
+        return at(RelativePosition{a, wrap_mode});
+
+    // We integrate in the interpolation color space, where the segments are straight lines, and convert the average at the end
+
+    ColorRGBA total{0.f, 0.f, 0.f, 0.f};
+    switch (wrap_mode)
+    {
+    case WrapMode::Clamp:
+    {
+        // Outside of the [0, 1] range, the gradient has the color of its ends.
+        if (a < 0.f)
+            total = sum(total, scaled(color_in_color_space(0.f), std::min(b, 0.f) - a));
+        if (b > 1.f)
+            total = sum(total, scaled(color_in_color_space(1.f), b - std::max(a, 1.f)));
+        if (a < 1.f && b > 0.f)
+            total = sum(total, integral(std::max(a, 0.f), std::min(b, 1.f)));
+        break;
+    }
+    case WrapMode::Repeat:
+    case WrapMode::MirrorRepeat:
+    {
+        // Both modes repeat the [0, 1] range, and MirrorRepeat flips every other copy.
+        const bool  mirror           = wrap_mode == WrapMode::MirrorRepeat;
+        const float first_copy       = std::floor(a);
+        const float last_copy        = std::floor(b);
+        const auto  integral_in_copy = [&](float copy, float begin, float end) {
+            const bool is_flipped = mirror && std::fmod(std::abs(copy), 2.f) == 1.f;
+            return is_flipped ? integral(1.f - end, 1.f - begin)
+                              : integral(begin, end);
+        };
+        if (first_copy == last_copy)
+        {
+            total = integral_in_copy(first_copy, a - first_copy, b - first_copy);
+        }
+        else
+        {
+            total = sum(integral_in_copy(first_copy, a - first_copy, 1.f),
+                        integral_in_copy(last_copy, 0.f, b - last_copy));
+            total = sum(total, scaled(integral(0.f, 1.f), last_copy - first_copy - 1.f));
+        }
+        break;
+    }
+    default:
+        assert(false && "[ImGuiGradient::average] Invalid enum value");
+    }
+    return internal::from_color_space(scaled(total, 1.f / (b - a)), _color_space);
+}
+
+void CompiledGradient::bake(ColorRGBA* colors, const size_t size) const
+{
+    sweep<internal::InterpolationPolicy<Interpolation::Cubic>>(
+        size,
+        [&](size_t i) { return internal::texel_center(i, size); },
+        [&](size_t i, const ColorRGBA& color) { colors[i] = color; }
+    );
+}
+
+void CompiledGradient::bake_rgba8(ImU32* colors, const size_t size) const
+{
+    sweep<internal::InterpolationPolicy<Interpolation::Cubic>>(
+        size,
+        [&](size_t i) { return internal::texel_center(i, size); },
+        [&](size_t i, const ColorRGBA& color) { colors[i] = internal::pack_rgba8(color); }
+    );
+}
+
+void CompiledGradient::bake_rgba16f(uint16_t* colors, const size_t size) const
+{
+    // Convert the colors by chunks, so that they are still in the cache and we can use the vectorized conversions
+    static constexpr size_t chunk_size = 256;
+    ColorRGBA               chunk[chunk_size];
+    sweep<internal::InterpolationPolicy<Interpolation::Cubic>>(
+        size,
+        [&](size_t i) { return internal::texel_center(i, size); },
+        [&](size_t i, const ColorRGBA& color) {
+            chunk[i % chunk_size] = color;
+            if (i % chunk_size == chunk_size - 1 || i == size - 1)
+            {
+                const size_t first = i - i % chunk_size;
+                internal::floats_to_halves(reinterpret_cast<const float*>(chunk), colors + 4 * first, 4 * (i - first + 1));
+            }
+        }
+    );
+}
+
+void CompiledGradient::sample_sorted(const float* positions, ColorRGBA* colors, const size_t count) const
+{
+    sweep<internal::InterpolationPolicy<Interpolation::Cubic>>(
+        count,
+        [&](size_t i) { return std::min(std::max(positions[i], 0.f), 1.f); }, // Clamping keeps the positions sorted. Sorted positions can't be NaN, so we don't need the slower std::fmin() and std::fmax()
+        [&](size_t i, const ColorRGBA& color) { colors[i] = color; }
+    );
+}
+
+void CompiledGradient::sample(const float* positions, ColorRGBA* colors, const size_t count, const WrapMode wrap_mode) const
+{
+    static const internal::SampleKernel kernel = internal::sample_kernel(internal::best_instruction_set());
+    const auto                          data   = sampling_data();
+    if (_color_space == ColorSpace::sRGB)
+    {
+        kernel(data, positions, colors, count, wrap_mode);
+        return;
+    }
+    // Convert the colors by chunks, while they are still in the cache
+    static constexpr size_t chunk_size = 256;
+    for (size_t first = 0; first < count; first += chunk_size)
+    {
+        const size_t chunk_count = std::min(chunk_size, count - first);
+        kernel(data, positions + first, colors + first, chunk_count, wrap_mode);
+        internal::from_color_space(colors + first, chunk_count, _color_space);
+    }
+}
+
+} // namespace ImGG
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "ColorRGBA.hpp"
+#include "ColorSpace.hpp"
+#include "Interpolation.hpp"
+#include "InterpolationPolicy.hpp"
+#include "RelativePosition.hpp"
+#include "SamplingData.hpp"
+#include "Utils.hpp"
+#include "WrapMode.hpp"
+
+namespace ImGG {
+
+class Gradient;
+
+/// A read-only snapshot of a `Gradient`, optimized for sampling.
+/// All the marks are stored in flat arrays, and everything that doesn't depend on the sampled position is precomputed,
+/// so sampling doesn't need to walk a `std::list` nor to do any division.
+/// The colors of the marks are stored already converted to the interpolation color space, so each sample is a single lerp followed by a single conversion back to sRGB.
+/// It is not updated when the `Gradient` changes: call `Gradient::compile()` again to get an up-to-date one.
+class CompiledGradient {
+public:
+    CompiledGradient();
+    explicit CompiledGradient(const Gradient&);
+
+    /// Returns the same color as `Gradient::at()` would.
+    auto at(RelativePosition) const -> ColorRGBA;
+
+    /// Same as `at(RelativePosition{position, wrap_mode})`, but the modes are known at compile time so there is no switch on them in the generated code.
+    /// `interpolation_mode` must be the one of the gradient that was compiled.
+    template<WrapMode wrap_mode, Interpolation interpolation_mode>
+    auto at(float position) const -> ColorRGBA
+    {
+        return at<wrap_mode, internal::InterpolationPolicy<interpolation_mode>>(position);
+    }
+
+    /// Same as `at<wrap_mode, interpolation_mode>()`, but with any interpolation policy, e.g. `EasedInterpolation<Smoothstep>`.
+    /// `InterpolationPolicy::interpolation_mode()` must be the interpolation mode of the gradient that was compiled.
+    /// Exactly on a mark this returns the color precomputed by `compile()`, i.e. the one of `interpolation_mode()`, which can differ slightly from what `Gradient::at<wrap_mode, InterpolationPolicy>()` returns there.
+    template<WrapMode wrap_mode, typename InterpolationPolicy>
+    auto at(float position) const -> ColorRGBA
+    {
+        assert(InterpolationPolicy::interpolation_mode() == _interpolation_mode && "The interpolation mode doesn't match the one of the gradient");
+        const auto  data = sampling_data();
+        const float pos  = internal::wrap_position<wrap_mode>(position).get();
+        return internal::from_color_space(internal::color_at<InterpolationPolicy>(data, internal::segment_index(data, pos), pos), _color_space);
+    }
+
+    /// Fills `colors` with `size` evenly spaced samples of the gradient, in a single sweep over the marks.
+    /// Sample `i` is taken at the center of texel `i`, i.e. at position `(i + 0.5) / size`, so that the result can be uploaded directly as a 1D texture.
+    void bake(ColorRGBA* colors, size_t size) const;
+    /// Same as `bake()`, but with any interpolation policy, e.g. `EasedInterpolation<Smoothstep>`, which is inlined in the loop.
+    /// `InterpolationPolicy::interpolation_mode()` must be the interpolation mode of the gradient that was compiled.
+    template<typename InterpolationPolicy>
+    void bake(ColorRGBA* colors, size_t size) const
+    {
+        assert(InterpolationPolicy::interpolation_mode() == _interpolation_mode && "The interpolation mode doesn't match the one of the gradient");
+        sweep<InterpolationPolicy>(
+            size,
+            [&](size_t i) { return internal::texel_center(i, size); },
+            [&](size_t i, const ColorRGBA& color) { colors[i] = color; }
+        );
+    }
+    /// Same as `bake()`, but packs the colors as 8-bit RGBA, like `ImGui::ColorConvertFloat4ToU32()` does.
+    void bake_rgba8(ImU32* colors, size_t size) const;
+    /// Same as `bake()`, but stores the colors as IEEE half floats, e.g. to upload them as a RGBA16F texture.
+    /// `colors` must have room for `4 * size` values (R, G, B, A, R, G, B, A, ...).
+    /// The conversion uses the F16C instructions when the CPU supports them.
+    void bake_rgba16f(uint16_t* colors, size_t size) const;
+
+    /// Samples the gradient at `count` arbitrary `positions`, and writes the results in `colors`.
+    /// `positions` can be outside of the [0, 1] range, they are mapped back into it according to `wrap_mode`.
+    /// This uses the fastest SIMD instruction set (SSE2, AVX2 or NEON) that the CPU supports, which is detected at runtime.
+    void sample(const float* positions, ColorRGBA* colors, size_t count, WrapMode wrap_mode) const;
+    /// Same as `sample()`, but with any interpolation policy, e.g. `EasedInterpolation<Smoothstep>`, which is inlined in the loop.
+    /// The SIMD kernels only know the built-in modes, so this is a scalar loop.
+    /// `InterpolationPolicy::interpolation_mode()` must be the interpolation mode of the gradient that was compiled.
+    template<typename InterpolationPolicy>
+    void sample(const float* positions, ColorRGBA* colors, size_t count, WrapMode wrap_mode) const
+    {
+        assert(InterpolationPolicy::interpolation_mode() == _interpolation_mode && "The interpolation mode doesn't match the one of the gradient");
+        switch (wrap_mode)
+        {
+        case WrapMode::Clamp:
+            return sample_impl<WrapMode::Clamp, InterpolationPolicy>(positions, colors, count);
+        case WrapMode::Repeat:
+            return sample_impl<WrapMode::Repeat, InterpolationPolicy>(positions, colors, count);
+        case WrapMode::MirrorRepeat:
+            return sample_impl<WrapMode::MirrorRepeat, InterpolationPolicy>(positions, colors, count);
+        default:
+            assert(false && "[ImGuiGradient::CompiledGradient::sample] Invalid enum value");
+        }
+    }
+
+    /// Same as `sample()`, but the `positions` must be sorted in increasing order, and the ones outside of the [0, 1] range are clamped.
+    /// Instead of searching the marks for each position, this walks the positions and the marks together, in O(count + number of marks).
+    void sample_sorted(const float* positions, ColorRGBA* colors, size_t count) const;
+
+    /// The average color of the gradient between positions `a` and `b`, e.g. to filter the gradient when a single pixel covers a wide range of positions.
+    /// The positions can be outside of the [0, 1] range, they are mapped back into it according to `wrap_mode`.
+    /// The integral of the gradient is precomputed on each mark, so this costs the same no matter how wide the interval is.
+    /// The colors are averaged in the interpolation color space.
+    auto average(float a, float b, WrapMode wrap_mode) const -> ColorRGBA;
+
+    auto interpolation_mode() const -> Interpolation { return _interpolation_mode; }
+    auto color_space() const -> ColorSpace { return _color_space; }
+
+    /// Gives access to the raw arrays, e.g. to write your own sampling loops.
+    /// The view is invalidated when this `CompiledGradient` is destroyed or modified.
+    auto sampling_data() const -> internal::SamplingData;
+
+private:
+    /// Same as `at()`, but without converting the color back to sRGB.
+    auto color_in_color_space(float position) const -> ColorRGBA;
+    /// The integral of the gradient between `begin` and `end`, which must be in the [0, 1] range, with `begin <= end`.
+    auto integral(float begin, float end) const -> ColorRGBA;
+
+    /// Calls `output(i, color)` for all the `position_at(i)`, which must be increasing, in a single sweep over the marks.
+    /// The segments of all the built-in modes are cubic polynomials whose unused terms are 0, so the `Interpolation::Cubic` policy can sample all of them.
+    template<typename InterpolationPolicy, typename PositionAt, typename Output>
+    void sweep(size_t count, PositionAt&& position_at, Output&& output) const
+    {
+        const auto data  = sampling_data();
+        size_t     index = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float position = position_at(i);
+            assert((i == 0 || position >= position_at(i - 1)) && "The positions must be sorted in increasing order");
+            // The positions are increasing, so the segment can only move forward.
+            while (index < data.positions_count && data.positions[index] < position)
+            {
+                ++index;
+            }
+            output(i, internal::from_color_space(internal::color_at<InterpolationPolicy>(data, index, position), data.color_space)); // Converting here fuses the conversion with the sampling, so that each color is only written once
+        }
+    }
+
+    template<WrapMode wrap_mode, typename InterpolationPolicy>
+    void sample_impl(const float* positions, ColorRGBA* colors, size_t count) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            colors[i] = at<wrap_mode, InterpolationPolicy>(positions[i]);
+        }
+    }
+
+private:
+    // See `internal::SamplingData` for the meaning of these arrays.
+    std::vector<float>             _positions{};
+    std::vector<ColorRGBA>         _colors_on_marks{}; // What `Gradient::at()` returns when sampling exactly on each of the positions.
+    std::vector<internal::Segment> _segments{};
+    std::vector<ColorRGBA>         _integrals{}; // The integral of the gradient between 0 and each of the positions.
+
+    Interpolation _interpolation_mode{Interpolation::Linear};
+    ColorSpace    _color_space{ColorSpace::sRGB}; // All the colors above are in this color space
+};
+
+} // namespace ImGG
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "InterpolationPolicy.hpp"
+
+namespace ImGG {
+
+/// An interpolation policy that blends the two marks around the position like `Interpolation::Linear`, but remaps the blend factor with `Easing::ease()`
+/// (after the `Mark::midpoint` of the segment has been applied).
+/// `Easing` must have a `static auto ease(float t) -> float` function, with `ease(0.f) == 0.f` and `ease(1.f) == 1.f` so that the gradient stays continuous on the marks.
+/// It reuses the segments of `Interpolation::Linear`, so the gradients that you sample with it must use `Interpolation::Linear`.
+///
+/// Pass it as a template parameter to `Gradient::at()`, `CompiledGradient::at()`, `CompiledGradient::bake()` or `CompiledGradient::sample()`:
+/// `ease()` is inlined in the sampling loop, there is no indirect call per sample.
+template<typename Easing>
+struct EasedInterpolation {
+    static constexpr auto interpolation_mode() -> Interpolation { return Interpolation::Linear; }
+
+    static auto interpolate(const internal::SurroundingMarks& marks, RelativePosition position) -> ColorRGBA
+    {
+        const Mark& lower      = *marks.lower;
+        const Mark& upper      = *marks.upper;
+        const float mix_factor = Easing::ease(internal::MidpointBias{upper.midpoint}((position.get() - lower.position.get())
+                                                                                   / (upper.position.get() - lower.position.get())));
+        return ColorRGBA{
+            lower.color.x + (upper.color.x - lower.color.x) * mix_factor,
+            lower.color.y + (upper.color.y - lower.color.y) * mix_factor,
+            lower.color.z + (upper.color.z - lower.color.z) * mix_factor,
+            lower.color.w + (upper.color.w - lower.color.w) * mix_factor,
+        };
+    }
+
+    static auto interpolate(const internal::SurroundingMarks& marks, RelativePosition position, ColorSpace color_space) -> ColorRGBA
+    {
+        return internal::interpolate_in_color_space<EasedInterpolation>(marks, position, color_space);
+    }
+
+    static auto segment_color(const internal::Segment& segment, float position) -> ColorRGBA
+    {
+        const float t = Easing::ease(internal::segment_t(segment, position));
+        return ColorRGBA{
+            segment.color.x + segment.slope.x * t,
+            segment.color.y + segment.slope.y * t,
+            segment.color.z + segment.slope.z * t,
+            segment.color.w + segment.slope.w * t,
+        };
+    }
+};
+
+/// Eases in and out of each mark: the gradient is flat on the marks and steepest halfway between them.
+struct Smoothstep {
+    static auto ease(float t) -> float { return t * t * (3.f - 2.f * t); }
+};
+
+} // namespace ImGG
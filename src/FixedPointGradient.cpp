@@ -0,0 +1,117 @@
+#include "FixedPointGradient.hpp"
+#include <algorithm>
+#include <cassert>
+#include "Gradient.hpp"
+
+namespace ImGG {
+
+static constexpr ColorRGBA8 black{0, 0, 0, 255};
+
+static auto reciprocal(uint32_t width) -> uint64_t
+{
+    return (uint64_t{1} << 32) / width;
+}
+
+/// `offset / width`, as a 16-bit fraction between 0 (included) and 65536 (excluded).
+static auto fraction(uint32_t offset, uint64_t reciprocal_of_width) -> uint32_t
+{
+    return static_cast<uint32_t>((offset * reciprocal_of_width) >> 16);
+}
+
+/// Rounds `(a * (65536 - t) + b * t) / 65536`. All the terms are positive, so the result doesn't depend on how the compiler shifts negative numbers.
+static auto lerp(uint8_t a, uint8_t b, uint32_t t) -> uint8_t
+{
+    return static_cast<uint8_t>((a * (65536u - t) + b * t + 32768u) >> 16);
+}
+
+static auto lerp(const ColorRGBA8& a, const ColorRGBA8& b, uint32_t t) -> ColorRGBA8
+{
+    return ColorRGBA8{lerp(a.r, b.r, t), lerp(a.g, b.g, t), lerp(a.b, b.b, t), lerp(a.a, b.a, t)};
+}
+
+static auto fixed_point_marks(const Gradient& gradient) -> std::vector<FixedPointMark>
+{
+    assert(FixedPointGradient::can_represent(gradient) && "FixedPointGradient doesn't support Interpolation::Cubic, color spaces other than sRGB, nor midpoints");
+    std::vector<FixedPointMark> marks;
+    for (const Mark& mark : gradient.get_marks())
+        marks.push_back(FixedPointMark{FixedPointGradient::to_fixed_point(mark.position.get()), internal::ColorTraits<ColorRGBA8>::from_rgba(mark.color)});
+    return marks;
+}
+
+auto FixedPointGradient::can_represent(const Gradient& gradient) -> bool
+{
+    return !gradient.is_curved();
+}
+
+auto FixedPointGradient::to_fixed_point(float position) -> FixedPointPosition
+{
+    return static_cast<FixedPointPosition>((position < 0.f ? 0.f : position > 1.f ? 1.f : position) * 65535.f + 0.5f);
+}
+
+FixedPointGradient::FixedPointGradient()
+    : FixedPointGradient{Gradient{}}
+{}
+
+FixedPointGradient::FixedPointGradient(const Gradient& gradient)
+    : FixedPointGradient{fixed_point_marks(gradient), gradient.interpolation_mode()}
+{}
+
+FixedPointGradient::FixedPointGradient(std::vector<FixedPointMark> marks, Interpolation interpolation_mode)
+    : _interpolation_mode{interpolation_mode}
+{
+    assert(interpolation_mode != Interpolation::Cubic && "FixedPointGradient doesn't support Interpolation::Cubic");
+    std::stable_sort(marks.begin(), marks.end(), [](const FixedPointMark& a, const FixedPointMark& b) { return a.position < b.position; });
+    for (const FixedPointMark& mark : marks)
+    {
+        if (_positions.empty() || _positions.back() != mark.position) // When several marks share the same position, only the first one is ever used by `Gradient::at()`.
+        {
+            _positions.push_back(mark.position);
+            _colors.push_back(mark.color);
+        }
+    }
+    _reciprocals.push_back(0);
+    for (size_t i = 1; i < _positions.size(); ++i)
+        _reciprocals.push_back(reciprocal(static_cast<uint32_t>(_positions[i] - _positions[i - 1])));
+    for (size_t i = 0; i < _positions.size(); ++i)
+        _colors_on_marks.push_back(color_on_mark(i));
+}
+
+/// Sampling exactly on a mark ignores it, and uses the marks around it (see `Gradient::at()`).
+auto FixedPointGradient::color_on_mark(size_t index) const -> ColorRGBA8
+{
+    const bool has_lower = index > 0;
+    const bool has_upper = index + 1 < _positions.size();
+    if (!has_lower && !has_upper)
+        return black;
+    if (!has_lower)
+        return _colors[index + 1];
+    if (!has_upper)
+        return _colors[index - 1];
+    if (_interpolation_mode == Interpolation::Constant)
+        return _colors[index + 1];
+    const uint32_t t = fraction(static_cast<uint32_t>(_positions[index] - _positions[index - 1]),
+                                reciprocal(static_cast<uint32_t>(_positions[index + 1] - _positions[index - 1])));
+    return lerp(_colors[index - 1], _colors[index + 1], t);
+}
+
+auto FixedPointGradient::at(const FixedPointPosition position) const -> ColorRGBA8
+{
+    const auto index = static_cast<size_t>(std::lower_bound(_positions.begin(), _positions.end(), position) - _positions.begin());
+    if (index < _positions.size() && _positions[index] == position)
+        return _colors_on_marks[index];
+    if (index == 0)
+        return _colors.empty() ? black : _colors.front();
+    if (index == _positions.size())
+        return _colors.back();
+    if (_interpolation_mode == Interpolation::Constant)
+        return _colors[index];
+    return lerp(_colors[index - 1], _colors[index], fraction(static_cast<uint32_t>(position - _positions[index - 1]), _reciprocals[index]));
+}
+
+void FixedPointGradient::sample(const FixedPointPosition* positions, ColorRGBA8* colors, size_t count) const
+{
+    for (size_t i = 0; i < count; ++i)
+        colors[i] = at(positions[i]);
+}
+
+} // namespace ImGG
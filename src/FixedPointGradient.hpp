@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "BasicColorRGBA.hpp"
+#include "Interpolation.hpp"
+
+namespace ImGG {
+
+class Gradient;
+
+/// A position stored on 16 bits: 0 is the beginning of the gradient and 65535 is the end.
+using FixedPointPosition = uint16_t;
+
+struct FixedPointMark {
+    FixedPointPosition position;
+    ColorRGBA8         color;
+};
+
+/// A read-only gradient that is sampled with integer math only, so that it gives exactly the same colors on all CPUs and with all compilers,
+/// e.g. for lockstep simulations and replays.
+/// The positions are stored on 16 bits and the colors on 8 bits per channel.
+/// The colors can only be interpolated in sRGB, and only linearly or with constant steps: check `can_represent()` before building one from a `Gradient`.
+/// It samples with the same rules as `Gradient::at()`, including on the marks themselves.
+class FixedPointGradient {
+public:
+    /// Black to white, like a default `Gradient`.
+    FixedPointGradient();
+    /// Rounds the positions of the marks to 16 bits and their colors to 8 bits.
+    /// This is the only step that uses floating point math: to be fully reproducible, build the gradient from `FixedPointMark`s.
+    /// `can_represent(gradient)` must be true.
+    explicit FixedPointGradient(const Gradient& gradient);
+    /// The `marks` don't need to be sorted. `interpolation_mode` can't be `Interpolation::Cubic`.
+    FixedPointGradient(std::vector<FixedPointMark> marks, Interpolation interpolation_mode);
+
+    auto at(FixedPointPosition position) const -> ColorRGBA8;
+    /// Samples the gradient at `count` `positions`, and writes the results in `colors`.
+    void sample(const FixedPointPosition* positions, ColorRGBA8* colors, size_t count) const;
+
+    auto interpolation_mode() const -> Interpolation { return _interpolation_mode; }
+
+    /// False iff `gradient` is `Gradient::is_curved()`, which a `FixedPointGradient` doesn't support, and so can't be converted to one.
+    static auto can_represent(const Gradient& gradient) -> bool;
+
+    /// Rounds a position between 0 and 1 to the closest `FixedPointPosition`.
+    static auto to_fixed_point(float position) -> FixedPointPosition;
+
+private:
+    auto color_on_mark(size_t index) const -> ColorRGBA8;
+
+private:
+    std::vector<FixedPointPosition> _positions{}; // The distinct positions of the marks, sorted
+    std::vector<ColorRGBA8>         _colors{};
+    std::vector<ColorRGBA8>         _colors_on_marks{}; // What `at()` returns when sampling exactly on each of the positions
+    std::vector<uint64_t>           _reciprocals{};     // 2^32 / (`_positions[i]` - `_positions[i - 1]`), so that we don't need any division when sampling
+    Interpolation                   _interpolation_mode{Interpolation::Linear};
+};
+
+} // namespace ImGG
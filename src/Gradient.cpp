@@ -1,30 +1,85 @@
 #include "Gradient.hpp"
-#include "imgui_internal.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
 
 namespace ImGG {
 
-void Gradient::sort_marks()
+Gradient::Gradient(const std::list<Mark>& marks)
+    : Gradient{Marks(marks.begin(), marks.end())}
+{}
+
+Gradient::Gradient(const std::vector<Mark>& marks)
+    : Gradient{Marks(marks.begin(), marks.end())}
+{}
+
+Gradient::Gradient(std::initializer_list<Mark> marks)
+    : Gradient{Marks(marks)}
+{}
+
+Gradient::Gradient(const Marks& marks)
+    : _marks{marks}
+    , _mark_slots{}
+    , _slots{}
 {
-    _marks.sort([](const Mark& a, const Mark& b) { return a.position < b.position; });
+    std::stable_sort(_marks.begin(), _marks.end(), [](const Mark& a, const Mark& b) { return a.position < b.position; });
+    for (uint32_t i = 0; i < _marks.size(); ++i)
+        _mark_slots.push_back(allocate_slot(i));
 }
 
-auto Gradient::find(MarkId id) const -> const Mark*
+constexpr size_t   Gradient::inline_marks_count;
+constexpr uint32_t Gradient::no_free_slot;
+
+auto Gradient::allocate_slot(const uint32_t mark_index) -> uint32_t
 {
-    return id.find(*this);
+    if (_first_free_slot == no_free_slot)
+    {
+        _slots.push_back(internal::MarkSlot{mark_index, 1});
+        return static_cast<uint32_t>(_slots.size() - 1);
+    }
+    const uint32_t slot     = _first_free_slot;
+    _first_free_slot        = _slots[slot].mark_index;
+    _slots[slot].mark_index = mark_index;
+    return slot;
 }
-auto Gradient::find(MarkId id) -> Mark*
+
+void Gradient::free_slot(const uint32_t slot)
 {
-    return id.find(*this);
+    _slots[slot].generation = _slots[slot].generation == UINT32_MAX ? 1 : _slots[slot].generation + 1; // Skip 0, which is the generation of the default-constructed ids
+    _slots[slot].mark_index = _first_free_slot;
+    _first_free_slot        = slot;
 }
 
-auto Gradient::find_iterator(MarkId id) const -> std::list<Mark>::const_iterator
+void Gradient::update_slots(const size_t begin, const size_t end)
+{
+    for (size_t i = begin; i < end; ++i)
+        _slots[_mark_slots[i]].mark_index = static_cast<uint32_t>(i);
+}
+
+auto Gradient::mark_index(const MarkId id) const -> size_t
+{
+    if (id._slot >= _slots.size() || _slots[id._slot].generation != id._generation)
+        return _marks.size();
+    return _slots[id._slot].mark_index;
+}
+
+auto Gradient::find(MarkId id) const -> const Mark*
+{
+    const size_t index = mark_index(id);
+    return index < _marks.size() ? &_marks[index] : nullptr;
+}
+auto Gradient::find(MarkId id) -> Mark*
 {
-    return id.find_iterator(*this);
+    const size_t index = mark_index(id);
+    return index < _marks.size() ? &_marks[index] : nullptr;
 }
 
-auto Gradient::find_iterator(MarkId id) -> std::list<Mark>::iterator
+auto Gradient::id_of(const Mark& mark) const -> MarkId
 {
-    return id.find_iterator(*this);
+    assert(&mark >= _marks.data() && &mark < _marks.data() + _marks.size() && "The mark is not one of the marks of this gradient");
+    const uint32_t slot = _mark_slots[static_cast<size_t>(&mark - _marks.data())];
+    return MarkId{slot, _slots[slot].generation};
 }
 
 auto Gradient::is_empty() const -> bool
@@ -34,34 +89,65 @@ auto Gradient::is_empty() const -> bool
 
 auto Gradient::add_mark(const Mark& mark) -> MarkId
 {
-    _marks.push_back(mark);
-    const auto id = MarkId{_marks.back()};
-    sort_marks();
-    return id;
+    // After the marks that have the same position, like a stable sort would do
+    const auto   position = std::upper_bound(_marks.begin(), _marks.end(), mark, [](const Mark& a, const Mark& b) { return a.position < b.position; });
+    const size_t index    = static_cast<size_t>(position - _marks.begin());
+    const auto   slot     = allocate_slot(static_cast<uint32_t>(index));
+    _marks.insert(position, mark);
+    _mark_slots.insert(_mark_slots.begin() + static_cast<std::ptrdiff_t>(index), slot);
+    update_slots(index + 1, _marks.size());
+    return MarkId{slot, _slots[slot].generation};
 }
 
 void Gradient::remove_mark(MarkId mark)
 {
-    const auto* const ptr = find(mark);
-    if (ptr)
-    {
-        _marks.remove(*ptr);
-    }
+    const size_t index = mark_index(mark);
+    if (index == _marks.size())
+        return;
+
+    free_slot(_mark_slots[index]);
+    _marks.erase(_marks.begin() + static_cast<std::ptrdiff_t>(index));
+    _mark_slots.erase(_mark_slots.begin() + static_cast<std::ptrdiff_t>(index));
+    update_slots(index, _marks.size());
 }
 
 void Gradient::clear()
 {
+    for (const uint32_t slot : _mark_slots)
+        free_slot(slot);
     _marks.clear();
+    _mark_slots.clear();
+}
+
+/// Moves the element at index `from` to index `to`, and shifts the ones in between by one.
+template<typename Vector>
+static void move_element(Vector& vector, const size_t from, const size_t to)
+{
+    const auto begin = vector.begin();
+    if (to < from)
+        std::rotate(begin + static_cast<std::ptrdiff_t>(to), begin + static_cast<std::ptrdiff_t>(from), begin + static_cast<std::ptrdiff_t>(from + 1));
+    else
+        std::rotate(begin + static_cast<std::ptrdiff_t>(from), begin + static_cast<std::ptrdiff_t>(from + 1), begin + static_cast<std::ptrdiff_t>(to + 1));
 }
 
 void Gradient::set_mark_position(const MarkId mark, const RelativePosition position)
 {
-    auto* const ptr = find(mark);
-    if (ptr)
-    {
-        ptr->position = position;
-        sort_marks();
-    }
+    const size_t index = mark_index(mark);
+    if (index == _marks.size())
+        return;
+
+    // The other marks are still sorted, so we can binary search where the mark goes.
+    // Like with a stable sort, it stays after the marks at the same position that were before it, and before the ones that were after it.
+    const auto begin     = _marks.begin();
+    const auto middle    = begin + static_cast<std::ptrdiff_t>(index);
+    const auto before    = std::upper_bound(begin, middle, position, [](const RelativePosition& pos, const Mark& mark) { return pos < mark.position; });
+    const auto after     = std::lower_bound(middle + 1, _marks.end(), position, [](const Mark& mark, const RelativePosition& pos) { return mark.position < pos; });
+    const auto new_index = static_cast<size_t>((before - begin) + (after - (middle + 1)));
+
+    _marks[index].position = position;
+    move_element(_marks, index, new_index);
+    move_element(_mark_slots, index, new_index);
+    update_slots(std::min(index, new_index), std::max(index, new_index) + 1);
 }
 
 void Gradient::set_mark_color(const MarkId mark, const ColorRGBA color)
@@ -83,6 +169,23 @@ auto Gradient::interpolation_mode() -> Interpolation&
     return _interpolation_mode;
 }
 
+auto Gradient::color_space() const -> ColorSpace
+{
+    return _color_space;
+}
+
+auto Gradient::color_space() -> ColorSpace&
+{
+    return _color_space;
+}
+
+auto Gradient::is_curved() const -> bool
+{
+    return _interpolation_mode == Interpolation::Cubic
+           || _color_space != ColorSpace::sRGB
+           || std::any_of(_marks.begin(), _marks.end(), [](const Mark& mark) { return mark.midpoint != 0.5f; });
+}
+
 void Gradient::spread_marks_evenly()
 {
     if (_marks.empty())
@@ -104,91 +207,73 @@ void Gradient::spread_marks_evenly()
     }
 }
 
-auto Gradient::get_marks() const -> const std::list<Mark>&
+auto Gradient::get_marks() const -> const Marks&
 {
     return _marks;
 }
 
-struct SurroundingMarks {
-    SurroundingMarks(const Mark* lower, const Mark* upper) // We need to explicitly define the constructor in order to compile with MacOS Clang in C++ 11
-        : lower{lower}
-        , upper{upper}
-    {}
-    const Mark* lower{nullptr};
-    const Mark* upper{nullptr};
-};
-
-/// Returns the marks positionned just before and after `position`, or nullptr if there is none.
-static auto get_marks_surrounding(const RelativePosition position, const std::list<Mark>& marks) -> SurroundingMarks
+auto Gradient::surrounding_marks(const RelativePosition position) const -> internal::SurroundingMarks
 {
-    const Mark* lower{nullptr};
-    const Mark* upper{nullptr};
-    for (const Mark& mark : marks)
-    {
-        if (mark.position > position && (!upper || mark.position < upper->position))
-        {
-            upper = &mark;
-        }
-        if (mark.position < position && (!lower || mark.position > lower->position))
-        {
-            lower = &mark;
-        }
-    }
-    return SurroundingMarks{lower, upper};
+    // The marks are sorted, so we can binary search them.
+    const auto upper = std::upper_bound(_marks.begin(), _marks.end(), position, [](const RelativePosition& pos, const Mark& mark) {
+        return pos < mark.position;
+    });
+    const auto lower = std::lower_bound(_marks.begin(), upper, position, [](const Mark& mark, const RelativePosition& pos) {
+        return mark.position < pos;
+    });
+    const auto count = static_cast<std::ptrdiff_t>(_marks.size());
+    const auto mark  = [&](std::ptrdiff_t index) -> const Mark& {
+        return _marks[static_cast<size_t>(index)];
+    };
+    // The first mark of the group of marks that share the position of mark `index`. There are hardly ever more than one or two marks at the same position, so we just walk back.
+    const auto group_begin = [&](std::ptrdiff_t index) {
+        while (index > 0 && mark(index - 1).position == mark(index).position)
+            --index;
+        return index;
+    };
+    // The index right after the group of marks that share the position of mark `index`.
+    const auto group_end = [&](std::ptrdiff_t index) {
+        const auto group_position = mark(index).position;
+        while (index < count && mark(index).position == group_position)
+            ++index;
+        return index;
+    };
+    const auto mark_at = [&](std::ptrdiff_t index) -> const Mark* {
+        return index >= 0 && index < count ? &mark(index) : nullptr;
+    };
+
+    const std::ptrdiff_t lower_index = lower != _marks.begin() ? group_begin(lower - _marks.begin() - 1) : -1;
+    const std::ptrdiff_t upper_index = upper - _marks.begin();
+    return internal::SurroundingMarks{
+        mark_at(lower_index),
+        mark_at(upper_index),
+        mark_at(lower_index > 0 ? group_begin(lower_index - 1) : -1),
+        mark_at(upper_index < count ? group_end(upper_index) : count),
+    };
 }
 
-static auto interpolate(const Mark& lower, const Mark& upper, const RelativePosition position, Interpolation interpolation_mode) -> ColorRGBA
+auto Gradient::at(const RelativePosition position) const -> ColorRGBA
 {
-    switch (interpolation_mode)
+    switch (_interpolation_mode)
     {
     case Interpolation::Linear:
-    {
-        const float mix_factor = (position.get() - lower.position.get())
-                                 / (upper.position.get() - lower.position.get());
-        return ImLerp(
-            lower.color,
-            upper.color,
-            mix_factor
-        );
-    }
+        return at_impl<internal::InterpolationPolicy<Interpolation::Linear>>(position);
 
     case Interpolation::Constant:
-    {
-        return upper.color;
-    }
+        return at_impl<internal::InterpolationPolicy<Interpolation::Constant>>(position);
+
+    case Interpolation::Cubic:
+        return at_impl<internal::InterpolationPolicy<Interpolation::Cubic>>(position);
 
     default:
-        assert(false && "[ImGuiGradient::interpolate] Invalid enum value");
+        assert(false && "[ImGuiGradient::at] Invalid enum value");
         return {-1.f, -1.f, -1.f, -1.f};
     }
 }
 
-auto Gradient::at(const RelativePosition position) const -> ColorRGBA
+auto Gradient::compile() const -> CompiledGradient
 {
-    const auto        surrounding_marks = get_marks_surrounding(position, _marks);
-    const Mark* const lower{surrounding_marks.lower};
-    const Mark* const upper{surrounding_marks.upper};
-
-    if (!lower && !upper)
-    {
-        return ColorRGBA{0.f, 0.f, 0.f, 1.f};
-    }
-    else if (upper && !lower)
-    {
-        return upper->color;
-    }
-    else if (!upper && lower)
-    {
-        return lower->color;
-    }
-    else if (upper == lower)
-    {
-        return upper->color;
-    }
-    else
-    {
-        return interpolate(*lower, *upper, position, _interpolation_mode);
-    }
+    return CompiledGradient{*this};
 }
 
 } // namespace ImGG
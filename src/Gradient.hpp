@@ -1,27 +1,75 @@
 #pragma once
 
+#include <cstdint>
+#include <initializer_list>
 #include <list>
+#include <vector>
+#include "ColorSpace.hpp"
+#include "CompiledGradient.hpp"
 #include "Interpolation.hpp"
+#include "InterpolationPolicy.hpp"
+#include "Mark.hpp"
 #include "MarkId.hpp"
+#include "SmallVector.hpp"
+#include "Utils.hpp"
 
 namespace ImGG {
 
+namespace internal {
+/// Where the mark of a `MarkId` currently is in the sorted marks of a `Gradient`.
+struct MarkSlot {
+    uint32_t mark_index; // When the slot is free, the index of the next free slot instead
+    uint32_t generation; // Incremented each time the slot is freed, so that the ids of the removed marks don't match anymore
+};
+} // namespace internal
+
 class Gradient {
 public:
+    /// Up to this many marks are stored inside of the `Gradient` itself: constructing, copying and moving such a gradient doesn't allocate.
+    static constexpr size_t inline_marks_count = 8;
+    using Marks                                = internal::SmallVector<Mark, inline_marks_count>;
+
     Gradient() = default;
-    explicit Gradient(const std::list<Mark>& marks)
-        : _marks{marks}
-    {}
+    explicit Gradient(const Marks& marks);
+    explicit Gradient(const std::list<Mark>& marks);
+    explicit Gradient(const std::vector<Mark>& marks);
+    explicit Gradient(std::initializer_list<Mark> marks); // Needed so that `Gradient{{mark1, mark2}}` is not ambiguous between the other constructors
 
     /// Returns the color at the given position in the gradient.
     /// 0.f corresponds to the beginning of the gradient and 1.f to the end.
     auto at(RelativePosition) const -> ColorRGBA;
 
+    /// Same as `at(RelativePosition{position, wrap_mode})`, but the modes are known at compile time so there is no switch on them in the generated code.
+    /// Use it in tight loops where you always sample with the same modes.
+    /// `interpolation_mode` must be the same as `interpolation_mode()`.
+    template<WrapMode wrap_mode, Interpolation interpolation_mode>
+    auto at(float position) const -> ColorRGBA
+    {
+        return at<wrap_mode, internal::InterpolationPolicy<interpolation_mode>>(position);
+    }
+
+    /// Same as `at<wrap_mode, interpolation_mode>()`, but with any interpolation policy, e.g. `EasedInterpolation<Smoothstep>`.
+    /// See `internal::InterpolationPolicy` for the functions that a policy must provide.
+    /// `InterpolationPolicy::interpolation_mode()` must be the same as `interpolation_mode()`.
+    template<WrapMode wrap_mode, typename InterpolationPolicy>
+    auto at(float position) const -> ColorRGBA
+    {
+        assert(InterpolationPolicy::interpolation_mode() == _interpolation_mode && "The interpolation mode doesn't match the one of the gradient");
+        return at_impl<InterpolationPolicy>(internal::wrap_position<wrap_mode>(position));
+    }
+
+    /// Returns a read-only copy of the gradient that is much faster to sample.
+    /// Use it when you sample the gradient a lot more often than you modify it.
+    auto compile() const -> CompiledGradient;
+
+    /// Returns nullptr if the mark is not in the gradient anymore.
+    /// The pointer is invalidated when a mark is added, removed or moved, so keep the `MarkId` rather than the pointer.
     auto find(MarkId) const -> const Mark*;
+    /// You can modify the color and the midpoint of the mark through the returned pointer, but to change its position you must use `set_mark_position()`.
     auto find(MarkId) -> Mark*;
-    auto find_iterator(MarkId id) const -> std::list<Mark>::const_iterator;
-    auto find_iterator(MarkId id) -> std::list<Mark>::iterator;
     auto contains(MarkId id) const -> bool { return find(id); }
+    /// `mark` must be one of the marks of `get_marks()`.
+    auto id_of(const Mark& mark) const -> MarkId;
     auto is_empty() const -> bool;
 
     auto add_mark(const Mark&) -> MarkId;
@@ -31,26 +79,63 @@ public:
     void set_mark_color(MarkId, ColorRGBA);
     auto interpolation_mode() const -> Interpolation;
     auto interpolation_mode() -> Interpolation&;
+    /// The color space in which the colors are interpolated.
+    /// `at()` has to convert the two marks around the position on each call, `compile()` the gradient to convert each mark only once.
+    auto color_space() const -> ColorSpace;
+    auto color_space() -> ColorSpace&;
+    /// True iff the colors are not interpolated with straight lines in sRGB (or constant steps) between the marks:
+    /// with `Interpolation::Cubic`, a `color_space()` other than `ColorSpace::sRGB`, or a `Mark::midpoint` other than 0.5.
+    auto is_curved() const -> bool;
 
     void spread_marks_evenly();
 
-    auto get_marks() const -> const std::list<Mark>&;
+    /// Sorted by position. Marks that share the same position are in the order in which they got that position.
+    auto get_marks() const -> const Marks&;
 
-    friend auto operator==(const Gradient& a, const Gradient& b) -> bool { return a._marks == b._marks; }
+    /// Also compares the interpolation modes and the color spaces, so that it can tell when a gradient needs to be baked again.
+    friend auto operator==(const Gradient& a, const Gradient& b) -> bool
+    {
+        return a._marks == b._marks
+               && a._interpolation_mode == b._interpolation_mode
+               && a._color_space == b._color_space;
+    }
+    friend auto operator!=(const Gradient& a, const Gradient& b) -> bool { return !(a == b); }
 
 private:
-    void sort_marks();
+    /// Returns the index in `_marks` of the mark, or `_marks.size()` if it is not in the gradient anymore.
+    auto mark_index(MarkId) const -> size_t;
+    /// Updates the slots of the marks in [`begin`, `end`), after they have moved in `_marks`.
+    void update_slots(size_t begin, size_t end);
+    auto allocate_slot(uint32_t mark_index) -> uint32_t;
+    void free_slot(uint32_t slot);
+
+    /// Returns the marks positionned just before and after `position`, and their neighbours, or nullptr if there is none.
+    /// When several marks share the same position, the first one is returned.
+    auto surrounding_marks(RelativePosition position) const -> internal::SurroundingMarks;
+
+    template<typename InterpolationPolicy>
+    auto at_impl(RelativePosition position) const -> ColorRGBA
+    {
+        return internal::color_between<InterpolationPolicy>(surrounding_marks(position), position, _color_space);
+    }
 
 private:
-    std::list<Mark> _marks{
-        // We use a std::list instead of a std::vector because it doesn't invalidate our iterators when adding, removing or sorting the marks.
+    static constexpr uint32_t no_free_slot = UINT32_MAX;
+
+    /// Sorted by position, so that `at()` can binary search them.
+    Marks _marks{
         Mark{RelativePosition{0.f}, ColorRGBA{0.f, 0.f, 0.f, 1.f}},
         Mark{RelativePosition{1.f}, ColorRGBA{1.f, 1.f, 1.f, 1.f}},
     };
+    /// `_mark_slots[i]` is the slot of `_marks[i]`, and `_slots[_mark_slots[i]].mark_index == i`.
+    /// The `MarkId`s refer to the slots, which don't move when the marks are sorted, so that they stay valid.
+    internal::SmallVector<uint32_t, inline_marks_count>           _mark_slots{0, 1};
+    internal::SmallVector<internal::MarkSlot, inline_marks_count> _slots{internal::MarkSlot{0, 1}, internal::MarkSlot{1, 1}};
+    uint32_t                                                      _first_free_slot{no_free_slot};
     /// Controls how the colors are interpolated between two marks.
     Interpolation _interpolation_mode{Interpolation::Linear};
-
-    friend class MarkId;
+    /// The color space in which the colors are interpolated.
+    ColorSpace _color_space{ColorSpace::sRGB};
 };
 
 } // namespace ImGG
\ No newline at end of file
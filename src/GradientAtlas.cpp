@@ -0,0 +1,76 @@
+#include "GradientAtlas.hpp"
+#include <cassert>
+
+namespace ImGG {
+
+static void bake(const CompiledGradient& gradient, ImU32* texels, size_t width)
+{
+    gradient.bake_rgba8(texels, width);
+}
+
+static void bake(const CompiledGradient& gradient, ColorRGBA* texels, size_t width)
+{
+    gradient.bake(texels, width);
+}
+
+template<typename Texel>
+GradientAtlas<Texel>::GradientAtlas(const size_t width)
+    : _width{width}
+{
+}
+
+template<typename Texel>
+auto GradientAtlas<Texel>::add(const Gradient& gradient) -> size_t
+{
+    _gradients.push_back(gradient);
+    _is_dirty.push_back(true);
+    _texels.resize(_texels.size() + _width);
+    bake_row(_gradients.size() - 1);
+    return _gradients.size() - 1;
+}
+
+template<typename Texel>
+auto GradientAtlas<Texel>::update(const size_t row, const Gradient& gradient) -> bool
+{
+    assert(row < height());
+    if (gradient == _gradients[row])
+        return false;
+
+    _gradients[row] = gradient;
+    _is_dirty[row]  = true;
+    bake_row(row);
+    return true;
+}
+
+template<typename Texel>
+void GradientAtlas<Texel>::bake_row(const size_t row)
+{
+    bake(_gradients[row].compile(), _texels.data() + row * _width, _width);
+}
+
+template<typename Texel>
+auto GradientAtlas<Texel>::dirty_rows() const -> std::vector<RowRange>
+{
+    std::vector<RowRange> ranges;
+    for (size_t row = 0; row < height(); ++row)
+    {
+        if (!_is_dirty[row])
+            continue;
+        if (!ranges.empty() && ranges.back().end == row)
+            ranges.back().end = row + 1;
+        else
+            ranges.push_back(RowRange{row, row + 1});
+    }
+    return ranges;
+}
+
+template<typename Texel>
+void GradientAtlas<Texel>::clear_dirty_rows()
+{
+    _is_dirty.assign(_is_dirty.size(), false);
+}
+
+template class GradientAtlas<ImU32>;
+template class GradientAtlas<ColorRGBA>;
+
+} // namespace ImGG
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include "ColorRGBA.hpp"
+#include "Gradient.hpp"
+#include "RowRange.hpp"
+
+namespace ImGG {
+
+/// Bakes many gradients into the rows of a single 2D table, e.g. to upload them all as one texture instead of one 1D texture per gradient.
+/// Each row has `width()` texels, baked like `CompiledGradient::bake()` does, and the rows are stored one after the other, without any padding.
+/// Call `update()` whenever a gradient might have changed: its row is only baked again when it actually did.
+/// The atlas remembers which rows have been modified since the last call to `clear_dirty_rows()`, so that you can upload only them.
+/// `Texel` is either `ImU32` (packed 8-bit RGBA, like `CompiledGradient::bake_rgba8()`) or `ColorRGBA`.
+template<typename Texel>
+class GradientAtlas {
+    static_assert(std::is_same<Texel, ImU32>::value || std::is_same<Texel, ColorRGBA>::value, "Only ImU32 and ColorRGBA texels are supported");
+
+public:
+    explicit GradientAtlas(size_t width);
+
+    /// Bakes `gradient` into a new row at the bottom of the atlas, and returns the index of that row.
+    auto add(const Gradient& gradient) -> size_t;
+
+    /// Bakes row `row` again if `gradient` is different from the one that was used to bake it.
+    /// Returns true iff the row was baked again.
+    auto update(size_t row, const Gradient& gradient) -> bool;
+
+    /// The rows that have been added or baked again since the last call to `clear_dirty_rows()`.
+    /// Consecutive rows are merged into a single range, and the ranges are sorted.
+    auto dirty_rows() const -> std::vector<RowRange>;
+    void clear_dirty_rows();
+
+    /// `height()` rows of `width()` texels.
+    auto data() const -> const Texel* { return _texels.data(); }
+    auto row(size_t row) const -> const Texel* { return _texels.data() + row * _width; }
+    auto width() const -> size_t { return _width; }
+    auto height() const -> size_t { return _gradients.size(); }
+
+private:
+    void bake_row(size_t row);
+
+private:
+    size_t                _width;
+    std::vector<Texel>    _texels{};
+    std::vector<Gradient> _gradients{}; // The gradients the rows were baked from, to detect when they change
+    std::vector<bool>     _is_dirty{};
+};
+
+using GradientAtlasRGBA8 = GradientAtlas<ImU32>;
+using GradientAtlasRGBA  = GradientAtlas<ColorRGBA>;
+
+} // namespace ImGG
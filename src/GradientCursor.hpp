@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include "ColorRGBA.hpp"
+#include "CompiledGradient.hpp"
+#include "RelativePosition.hpp"
+#include "SamplingData.hpp"
+
+namespace ImGG {
+
+/// Samples a `CompiledGradient` at positions that are close to the previous one, e.g. when walking along a timeline or a scanline.
+/// It remembers the segment of the last position it was asked for, and moves forward or backward from there,
+/// so that each query costs O(1) when the positions don't jump over many marks.
+/// It reads the arrays of the `CompiledGradient`, so it must not outlive it.
+class GradientCursor {
+public:
+    explicit GradientCursor(const CompiledGradient& gradient)
+        : _data{gradient.sampling_data()}
+    {}
+
+    /// Returns the same color as `CompiledGradient::at()` would.
+    auto at(RelativePosition position) -> ColorRGBA
+    {
+        const float pos = position.get();
+        while (_index < _data.positions_count && _data.positions[_index] < pos)
+        {
+            ++_index;
+        }
+        while (_index > 0 && _data.positions[_index - 1] >= pos)
+        {
+            --_index;
+        }
+        return internal::from_color_space(internal::color_at(_data, _index, pos), _data.color_space);
+    }
+
+private:
+    internal::SamplingData _data;
+    size_t                 _index{0}; // Always the index of the segment of the last position, see `internal::segment_index()`
+};
+
+} // namespace ImGG
@@ -9,35 +9,6 @@
 
 namespace ImGG {
 
-static auto new_mark_id(const Gradient& new_gradient, const Gradient& old_gradient, MarkId old_mark_id) -> MarkId
-{
-    const auto old_iterator = old_gradient.find_iterator(old_mark_id);
-    if (old_iterator != old_gradient.get_marks().end())
-    {
-        const auto dist = std::distance(
-            old_gradient.get_marks().begin(),
-            old_iterator
-        );
-        return MarkId{
-            std::next(
-                new_gradient.get_marks().begin(),
-                dist
-            )};
-    }
-    else
-    {
-        return MarkId{};
-    }
-}
-
-GradientWidget::GradientWidget(const GradientWidget& widget)
-    : _gradient{widget._gradient}
-    , _selected_mark{new_mark_id(_gradient, widget._gradient, widget._selected_mark)}
-    , _dragged_mark{new_mark_id(_gradient, widget._gradient, widget._dragged_mark)}
-    , _mark_to_hide{new_mark_id(_gradient, widget._gradient, widget._mark_to_hide)}
-    , _hover_checker{widget._hover_checker}
-{}
-
 static auto random_color(RandomNumberGenerator rng) -> ColorRGBA
 {
     return ColorRGBA{rng(), rng(), rng(), 1.f};
@@ -130,6 +101,28 @@ static auto open_color_picker_popup(
     }
 }
 
+static auto midpoint_slider(
+    Mark&       selected_mark,
+    const float width,
+    const bool  should_show_tooltip
+) -> bool
+{
+    ImGui::SetNextItemWidth(width);
+    const bool modified = ImGui::DragFloat(
+        "##midpoint",
+        &selected_mark.midpoint,
+        0.001f,       /* speed */
+        0.01f, 0.99f, /* min and max */
+        "Midpoint %.3f",
+        ImGuiSliderFlags_AlwaysClamp
+    );
+    if (should_show_tooltip)
+    {
+        tooltip("Where, between the previous mark and this one,\nthe color is halfway between theirs.");
+    }
+    return modified;
+}
+
 static void draw_gradient_bar(
     Gradient&    gradient,
     const ImVec2 gradient_bar_position,
@@ -194,7 +187,7 @@ auto GradientWidget::draw_gradient_marks(
     ImDrawList& draw_list = *ImGui::GetWindowDrawList();
     for (const Mark& mark : _gradient.get_marks())
     {
-        MarkId current_mark_id{mark};
+        const MarkId current_mark_id = _gradient.id_of(mark);
         if (_mark_to_hide != current_mark_id)
         {
             draw_marks(
@@ -302,20 +295,21 @@ auto GradientWidget::mouse_dragging_interactions(
     return is_dragging;
 }
 
-static auto next_selected_mark(const std::list<Mark>& gradient, MarkId mark) -> MarkId
+static auto next_selected_mark(const Gradient& gradient, MarkId mark) -> MarkId
 {
-    assert(!gradient.empty());
-    if (gradient.size() == 1)
+    const auto& marks = gradient.get_marks();
+    assert(!marks.empty());
+    if (marks.size() == 1)
     {
         return MarkId{};
     }
-    else if (mark == MarkId{gradient.front()})
+    else if (mark == gradient.id_of(marks.front()))
     {
-        return MarkId{gradient.back()};
+        return gradient.id_of(marks.back());
     }
     else
     {
-        return MarkId{gradient.front()};
+        return gradient.id_of(marks.front());
     };
 }
 
@@ -331,7 +325,8 @@ static auto compute_number_of_lines_under_bar(Settings const& settings) -> float
     if (!(settings.flags & Flag::NoAddButton)
         || !(settings.flags & Flag::NoRemoveButton)
         || !(settings.flags & Flag::NoPositionSlider)
-        || !(settings.flags & Flag::NoColorEdit))
+        || !(settings.flags & Flag::NoColorEdit)
+        || !(settings.flags & Flag::NoMidpointSlider))
     {
         res += 1.f;
     }
@@ -420,7 +415,7 @@ auto GradientWidget::widget(
     {
         if (_gradient.contains(_selected_mark) && _selected_mark == mark_to_delete)
         {
-            _selected_mark = next_selected_mark(_gradient.get_marks(), _selected_mark);
+            _selected_mark = next_selected_mark(_gradient, _selected_mark);
         }
         gradient().remove_mark(mark_to_delete);
         modified = true;
@@ -446,7 +441,7 @@ auto GradientWidget::widget(
         const auto wants_to_delete = delete_button_pressed || delete_key_pressed;
         if (wants_to_delete && _gradient.contains(_selected_mark))
         {
-            const MarkId new_selected_mark = next_selected_mark(_gradient.get_marks(), _selected_mark);
+            const MarkId new_selected_mark = next_selected_mark(_gradient, _selected_mark);
             gradient().remove_mark(_selected_mark);
             _selected_mark = new_selected_mark;
             modified       = true;
@@ -470,7 +465,7 @@ auto GradientWidget::widget(
 
     bool force_dont_deselect_mark = false;
 
-    const auto selected_mark = gradient().find(_selected_mark);
+    Mark* selected_mark = gradient().find(_selected_mark);
     if (selected_mark)
     {
         const auto is_there_color_edit{!(settings.flags & Flag::NoColorEdit)};
@@ -484,7 +479,8 @@ auto GradientWidget::widget(
             force_dont_deselect_mark = ImGui::IsItemActive(); // The color popup can go outside the border, but we don't want to deselect the mark when we click on it
         }
 
-        if (!(settings.flags & Flag::NoPositionSlider))
+        const auto is_there_position_slider{!(settings.flags & Flag::NoPositionSlider)};
+        if (is_there_position_slider)
         {
             if ((is_there_remove_button || is_there_add_button || is_there_color_edit))
             {
@@ -495,8 +491,19 @@ auto GradientWidget::widget(
             {
                 _dragged_mark.reset();
                 gradient().set_mark_position(_selected_mark, position);
-                modified = true;
+                selected_mark = gradient().find(_selected_mark); // set_mark_position() moves the marks around to keep them sorted, so the mark is not at the same address anymore
+                modified      = true;
+            }
+        }
+
+        if (!(settings.flags & Flag::NoMidpointSlider)
+            && selected_mark != &gradient().get_marks().front()) // The first mark doesn't have a previous mark, so its midpoint has no effect
+        {
+            if (is_there_remove_button || is_there_add_button || is_there_color_edit || is_there_position_slider)
+            {
+                ImGui::SameLine();
             }
+            modified |= midpoint_slider(*selected_mark, gradient_size.x * 0.25f, is_there_a_tooltip);
         }
     }
 
@@ -504,8 +511,9 @@ auto GradientWidget::widget(
     {
         if (ImGui::Button("Reset"))
         {
-            _gradient = {};
-            modified  = true;
+            _gradient     = {};
+            selected_mark = gradient().find(_selected_mark); // The mark has been destroyed along with the old gradient
+            modified      = true;
         }
     }
 
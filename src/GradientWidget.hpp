@@ -27,17 +27,6 @@ public:
         : _gradient{marks}
     {}
 
-    GradientWidget(const GradientWidget&);
-
-    GradientWidget& operator=(const GradientWidget& widget)
-    {
-        *this = GradientWidget{widget}; // Construct and then move-assign
-        return *this;
-    }
-
-    GradientWidget(GradientWidget&&) noexcept   = default;
-    GradientWidget& operator=(GradientWidget&&) = default;
-
     friend auto operator==(const GradientWidget& a, const GradientWidget& b) -> bool { return a.gradient() == b.gradient(); }
 
     auto gradient() const -> const Gradient& { return _gradient; }
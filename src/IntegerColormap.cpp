@@ -0,0 +1,45 @@
+#include "IntegerColormap.hpp"
+
+namespace ImGG {
+
+template<typename Integer>
+IntegerColormap<Integer>::IntegerColormap(const Gradient& gradient)
+    : _gradient{gradient}
+    , _table(table_size)
+{
+    build_table();
+}
+
+template<typename Integer>
+auto IntegerColormap<Integer>::update(const Gradient& gradient) -> bool
+{
+    if (gradient == _gradient)
+        return false;
+
+    _gradient = gradient;
+    build_table();
+    return true;
+}
+
+template<typename Integer>
+void IntegerColormap<Integer>::build_table()
+{
+    static constexpr float max_value = static_cast<float>(table_size - 1);
+
+    std::vector<float> positions(table_size);
+    for (size_t i = 0; i < table_size; ++i)
+    {
+        positions[i] = static_cast<float>(i) / max_value;
+    }
+    std::vector<ColorRGBA> colors(table_size);
+    _gradient.compile().sample(positions.data(), colors.data(), table_size, WrapMode::Clamp); // The positions are already in the [0, 1] range, so the wrap mode doesn't matter
+    for (size_t i = 0; i < table_size; ++i)
+    {
+        _table[i] = internal::pack_rgba8(colors[i]);
+    }
+}
+
+template class IntegerColormap<uint8_t>;
+template class IntegerColormap<uint16_t>;
+
+} // namespace ImGG
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "ColorRGBA.hpp"
+#include "Gradient.hpp"
+
+namespace ImGG {
+
+/// Maps 8-bit or 16-bit integer data to 8-bit RGBA colors, through a table that has one entry per possible value.
+/// Value `v` gets the color at position `v / max_value` in the gradient, i.e. the same color as `gradient.at(RelativePosition{v / max_value})`,
+/// so that colormapping raw sensor data is a single lookup per pixel, without any conversion to float nor any interpolation.
+/// Call `update()` whenever the gradient might have changed: the table is only rebuilt when it actually did.
+template<typename Integer>
+class IntegerColormap {
+    static_assert(std::is_same<Integer, uint8_t>::value || std::is_same<Integer, uint16_t>::value, "Only 8-bit and 16-bit data is supported");
+
+public:
+    static constexpr size_t table_size = size_t{1} << (8 * sizeof(Integer));
+
+    explicit IntegerColormap(const Gradient& gradient);
+
+    /// Rebuilds the table if `gradient` is different from the one that was used to build it.
+    /// Returns true iff the table was rebuilt.
+    auto update(const Gradient& gradient) -> bool;
+
+    auto operator()(Integer value) const -> ImU32 { return _table[value]; }
+
+    /// `table_size` packed colors, indexed by the integer values.
+    auto table() const -> const ImU32* { return _table.data(); }
+
+private:
+    void build_table();
+
+private:
+    Gradient           _gradient; // The gradient the table was built from, to detect when it changes
+    std::vector<ImU32> _table;
+};
+
+template<typename Integer>
+constexpr size_t IntegerColormap<Integer>::table_size;
+
+using IntegerColormap8  = IntegerColormap<uint8_t>;
+using IntegerColormap16 = IntegerColormap<uint16_t>;
+
+} // namespace ImGG
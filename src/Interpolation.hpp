@@ -10,6 +10,9 @@ enum class Interpolation : size_t { // We use size_t so that we can use the Wrap
     Linear,
     /// Constant color between two marks: it uses the color of the mark on the right.
     Constant,
+    /// Smooth curve through all the marks: the color and its rate of change are continuous on the marks.
+    /// The curve never overshoots: between two marks, each channel stays between the values it has on these two marks.
+    Cubic,
 };
 
 } // namespace ImGG
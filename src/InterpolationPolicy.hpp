@@ -0,0 +1,270 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include "ColorSpace.hpp"
+#include "Interpolation.hpp"
+#include "Mark.hpp"
+#include "SamplingData.hpp"
+#include "color_conversions.hpp"
+
+namespace ImGG { namespace internal {
+
+/// The marks around a position, or nullptr if there is none.
+struct SurroundingMarks {
+    SurroundingMarks(const Mark* lower, const Mark* upper, const Mark* before_lower = nullptr, const Mark* after_upper = nullptr) // We need to explicitly define the constructor in order to compile with MacOS Clang in C++ 11
+        : lower{lower}
+        , upper{upper}
+        , before_lower{before_lower}
+        , after_upper{after_upper}
+    {}
+    const Mark* lower{nullptr};
+    const Mark* upper{nullptr};
+    /// The neighbours of `lower` and `upper`, for the interpolation modes that look further than the two marks around the position.
+    const Mark* before_lower{nullptr};
+    const Mark* after_upper{nullptr};
+};
+
+/// The code that is specific to each `Interpolation` mode.
+/// Using it as a template parameter, instead of switching on the mode at runtime, allows the compiler to generate one specialized sampling loop per mode.
+///
+/// The built-in modes are nothing special: any type with the same static functions can be used as a policy, e.g. `EasedInterpolation<Smoothstep>`,
+/// and is inlined in the sampling loops exactly like them. A policy must provide:
+/// - `interpolation_mode() -> Interpolation`: the mode that the sampled gradients must use, which determines the segments that `CompiledGradient` precomputes.
+/// - `interpolate(const SurroundingMarks&, RelativePosition) -> ColorRGBA`: used by `Gradient`. `lower` and `upper` are never nullptr and never at the same position.
+/// - `interpolate(const SurroundingMarks&, RelativePosition, ColorSpace) -> ColorRGBA`: same, in another color space (`interpolate_in_color_space()` implements it for you).
+/// - `segment_color(const Segment&, float position) -> ColorRGBA`: used by `CompiledGradient`. The segment is the one precomputed for `interpolation_mode()`.
+template<Interpolation interpolation_mode>
+struct InterpolationPolicy;
+
+/// Calls `Policy::interpolate()` with the colors of the `marks` converted to `color_space`, and converts the result back to sRGB.
+template<typename Policy>
+auto interpolate_in_color_space(const SurroundingMarks& marks, RelativePosition position, ColorSpace color_space) -> ColorRGBA
+{
+    Mark       converted[4];
+    const auto convert = [&](const Mark* mark, Mark& result) -> const Mark* {
+        if (!mark)
+            return nullptr;
+        result = Mark{mark->position, to_color_space(mark->color, color_space), mark->midpoint};
+        return &result;
+    };
+    const auto converted_marks = SurroundingMarks{
+        convert(marks.lower, converted[0]),
+        convert(marks.upper, converted[1]),
+        convert(marks.before_lower, converted[2]),
+        convert(marks.after_upper, converted[3]),
+    };
+    return from_color_space(Policy::interpolate(converted_marks, position), color_space);
+}
+
+template<>
+struct InterpolationPolicy<Interpolation::Linear> {
+    static constexpr auto interpolation_mode() -> Interpolation { return Interpolation::Linear; }
+
+    /// The color between `marks.lower` and `marks.upper`, at `position`.
+    static auto interpolate(const SurroundingMarks& marks, RelativePosition position) -> ColorRGBA
+    {
+        const Mark& lower      = *marks.lower;
+        const Mark& upper      = *marks.upper;
+        const float mix_factor = MidpointBias{upper.midpoint}((position.get() - lower.position.get())
+                                                              / (upper.position.get() - lower.position.get()));
+        return ColorRGBA{ // Same as ImLerp()
+            lower.color.x + (upper.color.x - lower.color.x) * mix_factor,
+            lower.color.y + (upper.color.y - lower.color.y) * mix_factor,
+            lower.color.z + (upper.color.z - lower.color.z) * mix_factor,
+            lower.color.w + (upper.color.w - lower.color.w) * mix_factor,
+        };
+    }
+
+    /// Same as `interpolate()`, but the colors are interpolated in `color_space`.
+    static auto interpolate(const SurroundingMarks& marks, RelativePosition position, ColorSpace color_space) -> ColorRGBA
+    {
+        return interpolate_in_color_space<InterpolationPolicy>(marks, position, color_space);
+    }
+
+    /// The color of a compiled `segment`, at `position`.
+    static auto segment_color(const Segment& segment, float position) -> ColorRGBA
+    {
+        const float t = segment_t(segment, position);
+        return ColorRGBA{
+            segment.color.x + segment.slope.x * t,
+            segment.color.y + segment.slope.y * t,
+            segment.color.z + segment.slope.z * t,
+            segment.color.w + segment.slope.w * t,
+        };
+    }
+};
+
+template<>
+struct InterpolationPolicy<Interpolation::Constant> {
+    static constexpr auto interpolation_mode() -> Interpolation { return Interpolation::Constant; }
+
+    static auto interpolate(const SurroundingMarks& marks, RelativePosition) -> ColorRGBA
+    {
+        return marks.upper->color;
+    }
+
+    static auto interpolate(const SurroundingMarks& marks, RelativePosition, ColorSpace) -> ColorRGBA
+    {
+        return marks.upper->color; // There is nothing to interpolate, so we don't need to convert the color
+    }
+
+    static auto segment_color(const Segment& segment, float) -> ColorRGBA
+    {
+        return segment.color; // Constant segments have no slope
+    }
+};
+
+/// A cubic Hermite curve between each pair of marks.
+/// The slopes on the marks are limited so that the curve never overshoots, with Steffen's method (https://ui.adsabs.harvard.edu/abs/1990A%26A...239..443S).
+template<>
+struct InterpolationPolicy<Interpolation::Cubic> {
+    static constexpr auto interpolation_mode() -> Interpolation { return Interpolation::Cubic; }
+
+    /// The slope of one channel on a mark, from the slopes of the segments on both sides of it and their widths.
+    static auto tangent(float previous_slope, float previous_width, float next_slope, float next_width) -> float
+    {
+        if (previous_slope * next_slope <= 0.f) // The mark is a local extremum, so the curve must be flat there to not overshoot it
+            return 0.f;
+        const float parabola_slope = (previous_slope * next_width + next_slope * previous_width) / (previous_width + next_width);
+        return std::copysign(std::min(std::min(2.f * std::abs(previous_slope), 2.f * std::abs(next_slope)), std::abs(parabola_slope)), parabola_slope);
+    }
+
+    /// The slope of the curve on `mark`, per unit of position. `previous` and `next` are its neighbours, or nullptr on the first and last marks.
+    /// On the first and last marks the curve simply follows the direction of the only segment that they have.
+    static auto tangent(const Mark* previous, const Mark& mark, const Mark* next) -> ColorRGBA
+    {
+        const auto slope = [](const Mark& a, const Mark& b) {
+            const float inverse_width = 1.f / (b.position.get() - a.position.get());
+            return ColorRGBA{
+                (b.color.x - a.color.x) * inverse_width,
+                (b.color.y - a.color.y) * inverse_width,
+                (b.color.z - a.color.z) * inverse_width,
+                (b.color.w - a.color.w) * inverse_width,
+            };
+        };
+        if (!previous && !next)
+            return ColorRGBA{0.f, 0.f, 0.f, 0.f};
+        if (!previous)
+            return slope(mark, *next);
+        if (!next)
+            return slope(*previous, mark);
+
+        const ColorRGBA previous_slope = slope(*previous, mark);
+        const ColorRGBA next_slope     = slope(mark, *next);
+        const float     previous_width = mark.position.get() - previous->position.get();
+        const float     next_width     = next->position.get() - mark.position.get();
+        return ColorRGBA{
+            tangent(previous_slope.x, previous_width, next_slope.x, next_width),
+            tangent(previous_slope.y, previous_width, next_slope.y, next_width),
+            tangent(previous_slope.z, previous_width, next_slope.z, next_width),
+            tangent(previous_slope.w, previous_width, next_slope.w, next_width),
+        };
+    }
+
+    /// The polynomial coefficients of the curve between `lower` and `upper`, given the slopes of the curve on them.
+    static auto segment(const Mark& lower, const Mark& upper, const ColorRGBA& lower_tangent, const ColorRGBA& upper_tangent) -> Segment
+    {
+        const float width = upper.position.get() - lower.position.get();
+        // The slopes are per unit of position, and the polynomial is expressed with `t` that goes from 0 to 1 over the segment.
+        const auto coefficients = [&](float lower_color, float upper_color, float lower_slope, float upper_slope, float& slope, float& quadratic, float& cubic) {
+            const float difference = upper_color - lower_color;
+            slope                  = lower_slope * width;
+            quadratic              = 3.f * difference - (2.f * lower_slope + upper_slope) * width;
+            cubic                  = (lower_slope + upper_slope) * width - 2.f * difference;
+        };
+
+        auto segment          = Segment{};
+        segment.start         = lower.position.get();
+        segment.inverse_width = 1.f / width;
+        segment.bias          = MidpointBias{upper.midpoint};
+        segment.color         = lower.color;
+        coefficients(lower.color.x, upper.color.x, lower_tangent.x, upper_tangent.x, segment.slope.x, segment.quadratic.x, segment.cubic.x);
+        coefficients(lower.color.y, upper.color.y, lower_tangent.y, upper_tangent.y, segment.slope.y, segment.quadratic.y, segment.cubic.y);
+        coefficients(lower.color.z, upper.color.z, lower_tangent.z, upper_tangent.z, segment.slope.z, segment.quadratic.z, segment.cubic.z);
+        coefficients(lower.color.w, upper.color.w, lower_tangent.w, upper_tangent.w, segment.slope.w, segment.quadratic.w, segment.cubic.w);
+        return segment;
+    }
+
+    static auto interpolate(const SurroundingMarks& marks, RelativePosition position) -> ColorRGBA
+    {
+        return segment_color(
+            segment(*marks.lower, *marks.upper,
+                    tangent(marks.before_lower, *marks.lower, marks.upper),
+                    tangent(marks.lower, *marks.upper, marks.after_upper)),
+            position.get()
+        );
+    }
+
+    static auto interpolate(const SurroundingMarks& marks, RelativePosition position, ColorSpace color_space) -> ColorRGBA
+    {
+        return interpolate_in_color_space<InterpolationPolicy>(marks, position, color_space);
+    }
+
+    /// Evaluates the polynomial with Horner's method.
+    /// This also works for the segments of the other modes, whose higher order terms are 0, and gives exactly the same results for them.
+    static auto segment_color(const Segment& segment, float position) -> ColorRGBA
+    {
+        const float t = segment_t(segment, position);
+        return ColorRGBA{
+            segment.color.x + t * (segment.slope.x + t * (segment.quadratic.x + t * segment.cubic.x)),
+            segment.color.y + t * (segment.slope.y + t * (segment.quadratic.y + t * segment.cubic.y)),
+            segment.color.z + t * (segment.slope.z + t * (segment.quadratic.z + t * segment.cubic.z)),
+            segment.color.w + t * (segment.slope.w + t * (segment.quadratic.w + t * segment.cubic.w)),
+        };
+    }
+};
+
+/// The color of a `Gradient` at `position`, given the marks around it (see `Gradient::surrounding_marks()`), in sRGB.
+/// The colors of the `marks` are in sRGB, and are interpolated in `color_space`.
+template<typename Policy>
+auto color_between(const SurroundingMarks& marks, RelativePosition position, ColorSpace color_space) -> ColorRGBA
+{
+    if (!marks.lower && !marks.upper)
+    {
+        return ColorRGBA{0.f, 0.f, 0.f, 1.f};
+    }
+    else if (marks.upper && !marks.lower)
+    {
+        return marks.upper->color;
+    }
+    else if (!marks.upper && marks.lower)
+    {
+        return marks.lower->color;
+    }
+    else if (marks.upper == marks.lower)
+    {
+        return marks.upper->color;
+    }
+    else
+    {
+        return color_space == ColorSpace::sRGB
+                   ? Policy::interpolate(marks, position)
+                   : Policy::interpolate(marks, position, color_space);
+    }
+}
+
+/// The color of the compiled gradient at `position`, in `data.color_space`.
+/// `index` must be `segment_index(data, position)`.
+/// This works for all the interpolation modes because their segments are all polynomials, whose unused terms are 0.
+inline auto color_at(const SamplingData& data, size_t index, float position) -> ColorRGBA
+{
+    if (index < data.positions_count && data.positions[index] == position)
+    {
+        return data.colors_on_marks[index];
+    }
+    return InterpolationPolicy<Interpolation::Cubic>::segment_color(data.segments[index], position);
+}
+
+/// Same as `color_at()`, but specialized for one interpolation policy.
+template<typename Policy>
+auto color_at(const SamplingData& data, size_t index, float position) -> ColorRGBA
+{
+    if (index < data.positions_count && data.positions[index] == position)
+    {
+        return data.colors_on_marks[index];
+    }
+    return Policy::segment_color(data.segments[index], position);
+}
+
+}} // namespace ImGG::internal
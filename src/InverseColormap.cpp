@@ -0,0 +1,244 @@
+#include "InverseColormap.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "InterpolationPolicy.hpp"
+
+namespace ImGG {
+
+// The biggest number of cells in the grid. More cells means fewer candidates per cell, but more memory and a longer construction.
+static constexpr size_t max_cells_count = 32768;
+// Colors a bit outside of the gradient (e.g. because they have been rounded to 8 bits) still get the fast path.
+static constexpr float grid_margin = 0.02f;
+// The number of straight lines that approximate each curve of an `Interpolation::Cubic` gradient.
+static constexpr size_t pieces_per_curve = 16;
+
+static auto channel(const ColorRGBA& color, size_t axis) -> float
+{
+    return axis == 0 ? color.x : axis == 1 ? color.y : axis == 2 ? color.z : color.w;
+}
+
+static auto dot(const ColorRGBA& a, const ColorRGBA& b) -> float
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
+
+static auto difference(const ColorRGBA& a, const ColorRGBA& b) -> ColorRGBA
+{
+    return ColorRGBA{a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w};
+}
+
+/// Returns the squared distance between `color` and the closest point of `segment`, which is at `t` along the segment.
+static auto squared_distance(const internal::ColorSegment& segment, const ColorRGBA& color, float& t) -> float
+{
+    const ColorRGBA direction      = difference(segment.end_color, segment.begin_color);
+    const float     squared_length = dot(direction, direction);
+    t                              = squared_length > 0.f
+                                         ? std::min(std::max(dot(difference(color, segment.begin_color), direction) / squared_length, 0.f), 1.f)
+                                         : 0.5f; // The middle of a band of constant color
+    const ColorRGBA offset = difference(color, ColorRGBA{
+                                                   segment.begin_color.x + direction.x * t,
+                                                   segment.begin_color.y + direction.y * t,
+                                                   segment.begin_color.z + direction.z * t,
+                                                   segment.begin_color.w + direction.w * t,
+                                               });
+    return dot(offset, offset);
+}
+
+static auto color_segments(const CompiledGradient& gradient) -> std::vector<internal::ColorSegment>
+{
+    const auto data = gradient.sampling_data();
+
+    std::vector<internal::ColorSegment> segments;
+    switch (gradient.interpolation_mode())
+    {
+    case Interpolation::Linear:
+    {
+        // The uniform segments before the first mark and after the last one have the same color as the ends of their neighbours, so we skip them.
+        for (size_t i = 1; i < data.positions_count; ++i)
+        {
+            const internal::Segment& segment = data.segments[i];
+            segments.push_back({
+                segment.color,
+                ColorRGBA{segment.color.x + segment.slope.x, segment.color.y + segment.slope.y, segment.color.z + segment.slope.z, segment.color.w + segment.slope.w},
+                data.positions[i - 1],
+                data.positions[i],
+                segment.bias, // The colors are still on a straight line, but the position doesn't move linearly along it
+            });
+        }
+        break;
+    }
+    case Interpolation::Cubic:
+    {
+        // The curves are approximated by a few straight lines
+        using Cubic = internal::InterpolationPolicy<Interpolation::Cubic>;
+        for (size_t i = 1; i < data.positions_count; ++i)
+        {
+            const auto position_of_piece = [&](size_t piece) {
+                return piece == pieces_per_curve
+                           ? data.positions[i]
+                           : data.positions[i - 1] + (data.positions[i] - data.positions[i - 1]) * static_cast<float>(piece) / static_cast<float>(pieces_per_curve);
+            };
+            for (size_t piece = 0; piece < pieces_per_curve; ++piece)
+            {
+                const float begin = position_of_piece(piece);
+                const float end   = position_of_piece(piece + 1);
+                segments.push_back({Cubic::segment_color(data.segments[i], begin), Cubic::segment_color(data.segments[i], end), begin, end, internal::MidpointBias{}});
+            }
+        }
+        break;
+    }
+    case Interpolation::Constant:
+    {
+        for (size_t i = 0; i <= data.positions_count; ++i)
+        {
+            const float begin = i == 0 ? 0.f : data.positions[i - 1];
+            const float end   = i == data.positions_count ? 1.f : data.positions[i];
+            if (begin < end)
+                segments.push_back({data.segments[i].color, data.segments[i].color, begin, end, internal::MidpointBias{}});
+        }
+        break;
+    }
+    default:
+        assert(false && "[ImGuiGradient::color_segments] Invalid enum value");
+    }
+
+    if (segments.empty()) // The whole gradient has a single color
+        segments.push_back({data.segments[0].color, data.segments[0].color, 0.f, 1.f, internal::MidpointBias{}});
+    return segments;
+}
+
+InverseColormap::InverseColormap(const CompiledGradient& gradient)
+    : _segments{color_segments(gradient)}
+    , _color_space{gradient.color_space()}
+{
+    for (uint32_t i = 0; i < _segments.size(); ++i)
+        _all_segments.push_back(i);
+
+    // Choose the size of the cells so that the grid covers all the colors of the gradient, with at most `max_cells_count` cells
+    float grid_max[4];
+    float max_extent = 0.f;
+    for (size_t axis = 0; axis < 4; ++axis)
+    {
+        _grid_min[axis] = std::numeric_limits<float>::max();
+        grid_max[axis]  = std::numeric_limits<float>::lowest();
+        for (const auto& segment : _segments)
+        {
+            _grid_min[axis] = std::min({_grid_min[axis], channel(segment.begin_color, axis), channel(segment.end_color, axis)});
+            grid_max[axis]  = std::max({grid_max[axis], channel(segment.begin_color, axis), channel(segment.end_color, axis)});
+        }
+        _grid_min[axis] -= grid_margin;
+        grid_max[axis] += grid_margin;
+        max_extent = std::max(max_extent, grid_max[axis] - _grid_min[axis]);
+    }
+    _cell_size         = max_extent / 64.f;
+    size_t cells_count = 0;
+    while (true)
+    {
+        cells_count = 1;
+        for (size_t axis = 0; axis < 4; ++axis)
+        {
+            _cells_count[axis] = std::max(static_cast<size_t>(std::ceil((grid_max[axis] - _grid_min[axis]) / _cell_size)), size_t{1});
+            cells_count *= _cells_count[axis];
+        }
+        if (cells_count <= max_cells_count)
+            break;
+        _cell_size *= 1.25f;
+    }
+
+    // For each cell, keep the segments that can be the closest to a color in the cell.
+    // The distance from any point in the cell to a segment is within `cell_radius` of the distance from the center of the cell to that segment,
+    // so no segment that is further than `closest + 2 * cell_radius` from the center can be the closest one.
+    const float        cell_radius = _cell_size; // Half of the diagonal of a 4D cube: sqrt(4) / 2 * size
+    std::vector<float> distances(_segments.size());
+    _cells_offsets.reserve(cells_count + 1);
+    _cells_offsets.push_back(0);
+    for (size_t cell = 0; cell < cells_count; ++cell)
+    {
+        float  center[4];
+        size_t coordinates = cell;
+        for (size_t axis = 0; axis < 4; ++axis)
+        {
+            center[axis] = _grid_min[axis] + (static_cast<float>(coordinates % _cells_count[axis]) + 0.5f) * _cell_size;
+            coordinates /= _cells_count[axis];
+        }
+        const ColorRGBA center_color{center[0], center[1], center[2], center[3]};
+
+        float closest = std::numeric_limits<float>::max();
+        for (size_t i = 0; i < _segments.size(); ++i)
+        {
+            float t{};
+            distances[i] = std::sqrt(squared_distance(_segments[i], center_color, t));
+            closest      = std::min(closest, distances[i]);
+        }
+        for (uint32_t i = 0; i < _segments.size(); ++i)
+        {
+            if (distances[i] <= closest + 2.f * cell_radius)
+                _cells_segments.push_back(i);
+        }
+        _cells_offsets.push_back(_cells_segments.size());
+    }
+}
+
+auto InverseColormap::cell_index(const ColorRGBA& color, size_t& index) const -> bool
+{
+    index         = 0;
+    size_t stride = 1;
+    for (size_t axis = 0; axis < 4; ++axis)
+    {
+        const float coordinate = (channel(color, axis) - _grid_min[axis]) / _cell_size;
+        if (!(coordinate >= 0.f && coordinate < static_cast<float>(_cells_count[axis]))) // Also catches NaNs
+            return false;
+        index += static_cast<size_t>(coordinate) * stride;
+        stride *= _cells_count[axis];
+    }
+    return true;
+}
+
+auto InverseColormap::find_among(const uint32_t* segment_indices, size_t count, const ColorRGBA& color) const -> InverseColormapResult
+{
+    float  best_squared_distance = std::numeric_limits<float>::max();
+    float  best_t                = 0.f;
+    size_t best_index            = segment_indices[0];
+    for (size_t i = 0; i < count; ++i)
+    {
+        float       t{};
+        const float distance = squared_distance(_segments[segment_indices[i]], color, t);
+        if (distance < best_squared_distance)
+        {
+            best_squared_distance = distance;
+            best_t                = t;
+            best_index            = segment_indices[i];
+        }
+    }
+    const internal::ColorSegment& segment  = _segments[best_index];
+    const float                   position = segment.begin_position + (segment.end_position - segment.begin_position) * segment.bias.inverse(best_t);
+    // Sampling exactly on a mark doesn't give the color of the ends of the segments (see `Gradient::at()`), so we stay strictly inside the segment.
+    return InverseColormapResult{
+        std::min(std::max(position, std::nextafter(segment.begin_position, segment.end_position)),
+                 std::nextafter(segment.end_position, segment.begin_position)),
+        std::sqrt(best_squared_distance),
+    };
+}
+
+auto InverseColormap::find(const ColorRGBA& srgb_color) const -> InverseColormapResult
+{
+    // The segments are straight lines in the interpolation color space, so that's where we search
+    const ColorRGBA color = internal::to_color_space(srgb_color, _color_space);
+    size_t          cell{};
+    if (!cell_index(color, cell))
+        return find_among(_all_segments.data(), _all_segments.size(), color);
+    return find_among(_cells_segments.data() + _cells_offsets[cell], _cells_offsets[cell + 1] - _cells_offsets[cell], color);
+}
+
+void InverseColormap::find_rgba8(const ImU32* colors, InverseColormapResult* results, size_t count) const
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        results[i] = i > 0 && colors[i] == colors[i - 1]
+                         ? results[i - 1]
+                         : find(ImGui::ColorConvertU32ToFloat4(colors[i]));
+    }
+}
+
+} // namespace ImGG
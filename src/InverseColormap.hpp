@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ColorRGBA.hpp"
+#include "CompiledGradient.hpp"
+
+namespace ImGG {
+
+struct InverseColormapResult {
+    /// The position in the gradient whose color is the closest to the query.
+    float position;
+    /// The distance between the query and the color at `position`, in the interpolation color space of the gradient (e.g. in OKLab, this is a perceptual distance).
+    float distance;
+};
+
+namespace internal {
+/// A piece of the gradient seen in color space: a straight line between two colors, in the interpolation color space of the gradient.
+/// The bands of constant color are a single point, i.e. `begin_color == end_color`.
+struct ColorSegment {
+    ColorRGBA    begin_color;
+    ColorRGBA    end_color;
+    float        begin_position;
+    float        end_position;
+    MidpointBias bias; // How the position moves along the line
+};
+} // namespace internal
+
+/// Finds the position in a gradient whose color is the closest to a given color, e.g. to recover the values of an image that was colormapped with that gradient.
+/// The gradient is indexed with a grid over color space, where each cell knows which parts of the gradient can be the closest to a color in that cell,
+/// so that each query only needs to look at a few segments instead of the whole gradient.
+/// When several positions have the same color (e.g. a band of constant color), the middle of the band is returned.
+/// With `Interpolation::Cubic`, each curve between two marks is approximated by a few straight lines.
+class InverseColormap {
+public:
+    explicit InverseColormap(const CompiledGradient& gradient);
+
+    auto find(const ColorRGBA& color) const -> InverseColormapResult;
+    /// Same as calling `find()` on all the `colors`, but faster on images that have runs of pixels of the same color.
+    void find_rgba8(const ImU32* colors, InverseColormapResult* results, size_t count) const;
+
+private:
+    auto find_among(const uint32_t* segment_indices, size_t count, const ColorRGBA& color) const -> InverseColormapResult;
+    /// Returns false if `color` is outside of the grid.
+    auto cell_index(const ColorRGBA& color, size_t& index) const -> bool;
+
+private:
+    std::vector<internal::ColorSegment> _segments{};
+    ColorSpace                          _color_space{ColorSpace::sRGB}; // The colors of the segments are in this color space
+    std::vector<uint32_t>               _all_segments{}; // 0, 1, 2, ..., used for the queries that are outside of the grid
+    // The grid covers the colors of the gradient (plus a margin), and has cubic cells.
+    float                 _grid_min[4]{};
+    float                 _cell_size{1.f};
+    size_t                _cells_count[4]{1, 1, 1, 1};
+    std::vector<size_t>   _cells_offsets{};  // The candidates of cell `i` are `_cells_segments[_cells_offsets[i]]` to `_cells_segments[_cells_offsets[i + 1] - 1]`
+    std::vector<uint32_t> _cells_segments{}; // The indices of the segments that can be the closest to a color in each cell
+};
+
+} // namespace ImGG
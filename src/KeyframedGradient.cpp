@@ -0,0 +1,219 @@
+#include "KeyframedGradient.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iterator>
+#include "InterpolationPolicy.hpp"
+#include "color_conversions.hpp"
+
+namespace ImGG {
+
+/// `(1 - factor) * a + factor * b`, which gives exactly `a` when `factor` is 0 and exactly `b` when it is 1, so that the gradient is exactly the one of the keyframes at their times.
+static auto blend(const ColorRGBA& a, const ColorRGBA& b, float factor) -> ColorRGBA
+{
+    return ColorRGBA{
+        (1.f - factor) * a.x + factor * b.x,
+        (1.f - factor) * a.y + factor * b.y,
+        (1.f - factor) * a.z + factor * b.z,
+        (1.f - factor) * a.w + factor * b.w,
+    };
+}
+
+KeyframedGradient::KeyframedGradient()
+    : KeyframedGradient{std::vector<Keyframe>{Keyframe{0.f, Gradient{}}}}
+{}
+
+KeyframedGradient::KeyframedGradient(std::vector<Keyframe> keyframes)
+    : _keyframes{std::move(keyframes)}
+{
+    assert(!_keyframes.empty() && "A KeyframedGradient needs at least one keyframe");
+    std::stable_sort(_keyframes.begin(), _keyframes.end(), [](const Keyframe& a, const Keyframe& b) { return a.time < b.time; });
+    _compiled_keyframes.reserve(_keyframes.size());
+    for (const Keyframe& keyframe : _keyframes)
+        _compiled_keyframes.push_back(keyframe.gradient.compile());
+    _transitions.resize(_keyframes.size() - 1);
+    for (size_t i = 0; i < _transitions.size(); ++i)
+        update_transition(i);
+}
+
+void KeyframedGradient::set_keyframe_gradient(const size_t index, const Gradient& gradient)
+{
+    assert(index < _keyframes.size());
+    _keyframes[index].gradient = gradient;
+    _compiled_keyframes[index] = gradient.compile();
+    if (index > 0)
+        update_transition(index - 1);
+    if (index < _transitions.size())
+        update_transition(index);
+}
+
+void KeyframedGradient::update_transition(const size_t index)
+{
+    const auto lower = _compiled_keyframes[index].sampling_data();
+    const auto upper = _compiled_keyframes[index + 1].sampling_data();
+
+    internal::KeyframeTransition& transition = _transitions[index];
+    transition.positions.clear();
+    std::merge(lower.positions, lower.positions + lower.positions_count, upper.positions, upper.positions + upper.positions_count, std::back_inserter(transition.positions));
+    transition.positions.erase(std::unique(transition.positions.begin(), transition.positions.end()), transition.positions.end());
+
+    // No mark of either keyframe is strictly between two consecutive merged positions, so all the positions of a merged segment
+    // have the same `segment_index()` as its end, in both keyframes. Both keyframes are sorted, so we can walk them along with the merged positions.
+    transition.lower_segments.resize(transition.positions.size() + 1);
+    transition.upper_segments.resize(transition.positions.size() + 1);
+    size_t lower_index = 0;
+    size_t upper_index = 0;
+    for (size_t i = 0; i < transition.positions.size(); ++i)
+    {
+        while (lower_index < lower.positions_count && lower.positions[lower_index] < transition.positions[i])
+            ++lower_index;
+        while (upper_index < upper.positions_count && upper.positions[upper_index] < transition.positions[i])
+            ++upper_index;
+        transition.lower_segments[i] = static_cast<uint32_t>(lower_index);
+        transition.upper_segments[i] = static_cast<uint32_t>(upper_index);
+    }
+    transition.lower_segments.back() = static_cast<uint32_t>(lower.positions_count);
+    transition.upper_segments.back() = static_cast<uint32_t>(upper.positions_count);
+}
+
+auto KeyframedGradient::blend_at(const float time) const -> internal::KeyframeBlend
+{
+    const auto upper = std::upper_bound(_keyframes.begin(), _keyframes.end(), time, [](float t, const Keyframe& keyframe) { return t < keyframe.time; });
+    if (upper == _keyframes.begin()) // Before the first keyframe
+        return internal::KeyframeBlend{0, 0.f};
+    if (upper == _keyframes.end()) // After the last keyframe
+        return internal::KeyframeBlend{_keyframes.size() - 1, 0.f};
+    const auto  lower  = upper - 1;
+    const float factor = (time - lower->time) / (upper->time - lower->time); // `upper->time > time >= lower->time`, so we never divide by 0
+    return internal::KeyframeBlend{static_cast<size_t>(lower - _keyframes.begin()), factor};
+}
+
+auto KeyframedGradient::at(const float time, const RelativePosition position) const -> ColorRGBA
+{
+    const auto blend_info = blend_at(time);
+    if (blend_info.factor == 0.f)
+        return _compiled_keyframes[blend_info.lower_keyframe].at(position);
+
+    const internal::KeyframeTransition& transition = _transitions[blend_info.lower_keyframe];
+    const float                         pos        = position.get();
+    const auto                          segment    = static_cast<size_t>(std::lower_bound(transition.positions.begin(), transition.positions.end(), pos) - transition.positions.begin());
+
+    const auto lower = _compiled_keyframes[blend_info.lower_keyframe].sampling_data();
+    const auto upper = _compiled_keyframes[blend_info.lower_keyframe + 1].sampling_data();
+    return blend(
+        internal::from_color_space(internal::color_at(lower, transition.lower_segments[segment], pos), lower.color_space),
+        internal::from_color_space(internal::color_at(upper, transition.upper_segments[segment], pos), upper.color_space),
+        blend_info.factor
+    );
+}
+
+KeyframedBake::KeyframedBake(const KeyframedGradient& gradient, const size_t positions_count, const size_t times_count)
+    : _positions_count{positions_count}
+    , _times_count{times_count}
+    , _table(positions_count * times_count)
+{
+    assert(positions_count > 0 && times_count > 0 && "The table can't be empty");
+    update(gradient);
+}
+
+auto KeyframedBake::row_time(const size_t row) const -> float
+{
+    return _start_time + internal::texel_center(row, _times_count) * (_end_time - _start_time);
+}
+
+void KeyframedBake::bake_keyframe(const KeyframedGradient& gradient, const size_t index)
+{
+    _keyframes[index] = gradient.keyframes()[index];
+    _keyframe_rows[index].resize(_positions_count);
+    gradient.compiled_keyframe(index).bake(_keyframe_rows[index].data(), _positions_count);
+}
+
+void KeyframedBake::blend_row(const KeyframedGradient& gradient, const size_t row)
+{
+    const auto             blend_info = gradient.blend_at(row_time(row));
+    const ColorRGBA* const lower      = _keyframe_rows[blend_info.lower_keyframe].data();
+    const ColorRGBA* const upper      = _keyframe_rows[std::min(blend_info.lower_keyframe + 1, _keyframe_rows.size() - 1)].data();
+    ColorRGBA* const       colors     = _table.data() + row * _positions_count;
+    for (size_t i = 0; i < _positions_count; ++i)
+        colors[i] = blend(lower[i], upper[i], blend_info.factor);
+}
+
+auto KeyframedBake::update(const KeyframedGradient& gradient) -> RowRange
+{
+    const std::vector<Keyframe>& keyframes = gradient.keyframes();
+
+    const bool same_times = keyframes.size() == _keyframes.size()
+                            && std::equal(keyframes.begin(), keyframes.end(), _keyframes.begin(), [](const Keyframe& a, const Keyframe& b) { return a.time == b.time; });
+    if (!same_times)
+    {
+        _keyframes  = keyframes;
+        _start_time = gradient.start_time();
+        _end_time   = gradient.end_time();
+        _keyframe_rows.assign(keyframes.size(), {});
+        for (size_t i = 0; i < keyframes.size(); ++i)
+            bake_keyframe(gradient, i);
+        for (size_t row = 0; row < _times_count; ++row)
+            blend_row(gradient, row);
+        return RowRange{0, _times_count};
+    }
+
+    std::vector<bool> has_changed(keyframes.size(), false);
+    bool              any_change = false;
+    for (size_t i = 0; i < keyframes.size(); ++i)
+    {
+        if (keyframes[i].gradient != _keyframes[i].gradient)
+        {
+            bake_keyframe(gradient, i);
+            has_changed[i] = true;
+            any_change     = true;
+        }
+    }
+    if (!any_change)
+        return RowRange{};
+
+    // Only the rows that are blended from a keyframe that has changed need to be blended again. They are contiguous around each of these keyframes.
+    auto range = RowRange{_times_count, 0};
+    for (size_t row = 0; row < _times_count; ++row)
+    {
+        const auto blend_info = gradient.blend_at(row_time(row));
+        if (has_changed[blend_info.lower_keyframe]
+            || (blend_info.factor != 0.f && has_changed[blend_info.lower_keyframe + 1]))
+        {
+            blend_row(gradient, row);
+            range.begin = std::min(range.begin, row);
+            range.end   = row + 1;
+        }
+    }
+    if (range.begin > range.end) // The keyframes that changed are not used by any row
+        return RowRange{};
+    return range;
+}
+
+/// The two texels around `coordinate` (from 0 to 1) in a row of `size` texels, clamped to the edges, and the weight of the second one.
+struct TexelsAround {
+    size_t first;
+    size_t second;
+    float  factor;
+};
+
+static auto texels_around(const float coordinate, const size_t size) -> TexelsAround
+{
+    const float  texel = std::fmin(std::fmax(coordinate * static_cast<float>(size) - 0.5f, 0.f), static_cast<float>(size - 1)); // std::fmin() and std::fmax() send NaNs to the first texel
+    const size_t first = static_cast<size_t>(texel);
+    return TexelsAround{first, std::min(first + 1, size - 1), texel - static_cast<float>(first)};
+}
+
+auto KeyframedBake::at(const float time, const RelativePosition position) const -> ColorRGBA
+{
+    const float normalized_time = _end_time > _start_time ? (time - _start_time) / (_end_time - _start_time) : 0.5f;
+    const auto  x               = texels_around(position.get(), _positions_count);
+    const auto  y               = texels_around(normalized_time, _times_count);
+    const auto  texel           = [&](size_t row, size_t column) -> const ColorRGBA& { return _table[row * _positions_count + column]; };
+    return blend(
+        blend(texel(y.first, x.first), texel(y.first, x.second), x.factor),
+        blend(texel(y.second, x.first), texel(y.second, x.second), x.factor),
+        y.factor
+    );
+}
+
+} // namespace ImGG
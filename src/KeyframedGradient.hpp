@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "ColorRGBA.hpp"
+#include "CompiledGradient.hpp"
+#include "Gradient.hpp"
+#include "RelativePosition.hpp"
+#include "RowRange.hpp"
+
+namespace ImGG {
+
+/// The gradient that a `KeyframedGradient` has at a given time.
+struct Keyframe {
+    Keyframe(float time, Gradient gradient) // We need to explicitly define the constructor in order to compile with MacOS Clang in C++ 11
+        : time{time}
+        , gradient{std::move(gradient)}
+    {}
+    float    time;
+    Gradient gradient;
+};
+
+namespace internal {
+/// Which segments of two consecutive keyframes match each other.
+/// `positions` are the positions of the marks of both keyframes, merged and sorted, so that between two of them both keyframes stay in the same segment:
+/// `lower_segments[i]` and `upper_segments[i]` are the `segment_index()`es, in the keyframes before and after the transition, of all the positions of segment `i` of `positions`.
+struct KeyframeTransition {
+    std::vector<float>    positions{};
+    std::vector<uint32_t> lower_segments{};
+    std::vector<uint32_t> upper_segments{};
+};
+
+/// Which keyframes are blended at a given time.
+struct KeyframeBlend {
+    size_t lower_keyframe; // The keyframe before the time, or the first one
+    float  factor;         // How far the time is from the lower keyframe towards the next one, from 0 to 1. It is 0 when there is no next keyframe.
+};
+} // namespace internal
+
+/// A gradient that changes over time, e.g. for an animated effect.
+/// Between two keyframes, its color at each position is the blend of the colors (in sRGB) of the two keyframes at that position, so it fades from one to the other.
+/// Before the first keyframe and after the last one, it is the gradient of that keyframe.
+/// The keyframes are compiled, and the segments of consecutive keyframes are matched once and for all, so that sampling searches the marks only once.
+class KeyframedGradient {
+public:
+    /// A single keyframe at time 0, with a default `Gradient`.
+    KeyframedGradient();
+    /// `keyframes` must not be empty, and don't need to be sorted.
+    explicit KeyframedGradient(std::vector<Keyframe> keyframes);
+
+    /// Returns the same color as blending `keyframes()[i].gradient.compile().at(position)` and the same for `i + 1`,
+    /// where `i` and `i + 1` are the keyframes around `time`.
+    auto at(float time, RelativePosition position) const -> ColorRGBA;
+
+    /// The keyframes, sorted by time.
+    auto keyframes() const -> const std::vector<Keyframe>& { return _keyframes; }
+    auto compiled_keyframe(size_t index) const -> const CompiledGradient& { return _compiled_keyframes[index]; }
+    /// Replaces the gradient of keyframe `index`. Only this keyframe is compiled again, and only its transitions with its two neighbours are recomputed.
+    void set_keyframe_gradient(size_t index, const Gradient& gradient);
+
+    auto start_time() const -> float { return _keyframes.front().time; }
+    auto end_time() const -> float { return _keyframes.back().time; }
+
+    /// The keyframes whose colors are blended at `time`.
+    auto blend_at(float time) const -> internal::KeyframeBlend;
+
+private:
+    void update_transition(size_t index);
+
+private:
+    std::vector<Keyframe>                     _keyframes{};
+    std::vector<CompiledGradient>             _compiled_keyframes{};
+    std::vector<internal::KeyframeTransition> _transitions{}; // `_transitions[i]` goes from keyframe `i` to keyframe `i + 1`
+};
+
+/// A 2D lookup table of a `KeyframedGradient`, e.g. to upload it as a 2D texture: each row is the gradient at one time.
+/// Row `y` is at time `start_time() + (y + 0.5) / times_count * (end_time() - start_time())`, and texel `x` of each row is at position `(x + 0.5) / positions_count`,
+/// so that the table has exactly the colors of `KeyframedGradient::at()` on the centers of the texels.
+/// Each keyframe is baked once into a row, and the rows of the table are blended from the rows of the two keyframes around them.
+/// Call `update()` whenever the gradient might have changed: only the rows that depend on the keyframes that actually changed are blended again.
+class KeyframedBake {
+public:
+    KeyframedBake(const KeyframedGradient& gradient, size_t positions_count, size_t times_count);
+
+    /// Bakes again the keyframes that are different from the ones of the last bake, and blends again the rows that depend on them.
+    /// Returns a range that contains all the rows that were modified, e.g. to only upload this part of the texture.
+    /// If the number of keyframes or their times have changed, the whole table is baked again.
+    auto update(const KeyframedGradient& gradient) -> RowRange;
+
+    /// Samples the table with bilinear filtering, and clamps outside of it, like a 2D texture with GL_LINEAR and GL_CLAMP_TO_EDGE.
+    auto at(float time, RelativePosition position) const -> ColorRGBA;
+
+    /// `times_count` rows of `positions_count` colors.
+    auto table() const -> const ColorRGBA* { return _table.data(); }
+    auto positions_count() const -> size_t { return _positions_count; }
+    auto times_count() const -> size_t { return _times_count; }
+
+private:
+    void bake_keyframe(const KeyframedGradient& gradient, size_t index);
+    void blend_row(const KeyframedGradient& gradient, size_t row);
+    auto row_time(size_t row) const -> float;
+
+private:
+    size_t                              _positions_count;
+    size_t                              _times_count;
+    std::vector<ColorRGBA>              _table;
+    std::vector<Keyframe>               _keyframes{};     // The keyframes the table was baked from, to detect when they change
+    std::vector<std::vector<ColorRGBA>> _keyframe_rows{}; // Each keyframe, baked into a row
+    float                               _start_time{0.f};
+    float                               _end_time{0.f};
+};
+
+} // namespace ImGG
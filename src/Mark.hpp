@@ -8,19 +8,26 @@ namespace ImGG {
 struct Mark {
     RelativePosition position;
     ColorRGBA        color;
+    /// Where, between the previous mark and this one, the color is halfway between theirs: 0.5 is the middle, smaller values move it towards the previous mark.
+    /// It has no effect on the first mark, nor with `Interpolation::Constant`. It is clamped to [0.01, 0.99].
+    /// `Gradient::compile()` precomputes the curve that remaps the positions once per mark, while `Gradient::at()` computes it again on each call.
+    float midpoint;
 
     Mark( // We need to explicitly define the constructor in order to compile with MacOS Clang in C++ 11
         RelativePosition position = RelativePosition{0.f},
-        ColorRGBA        color    = {0.f, 0.f, 0.f, 1.f}
+        ColorRGBA        color    = {0.f, 0.f, 0.f, 1.f},
+        float            midpoint = 0.5f
     )
         : position{position}
         , color{color}
+        , midpoint{midpoint}
     {}
 
     friend auto operator==(const Mark& a, const Mark& b) -> bool
     {
         return a.position == b.position
-               && a.color == b.color;
+               && a.color == b.color
+               && a.midpoint == b.midpoint;
     };
 };
 
@@ -0,0 +1,141 @@
+#include "PackedGradients.hpp"
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <limits>
+#include "Gradient.hpp"
+#include "InterpolationPolicy.hpp"
+#include "color_conversions.hpp"
+#include "sample_kernels.hpp"
+
+namespace ImGG {
+
+/// The arrays of a gradient, laid out like in `internal::PackedSamplingData`.
+struct PackedArrays {
+    std::vector<float>             positions;
+    std::vector<ColorRGBA>         colors_on_marks;
+    std::vector<internal::Segment> segments;
+};
+
+static auto packed_arrays(const internal::SamplingData& data) -> PackedArrays
+{
+    auto arrays = PackedArrays{
+        std::vector<float>(data.positions, data.positions + data.positions_count),
+        std::vector<ColorRGBA>(data.colors_on_marks, data.colors_on_marks + data.positions_count),
+        std::vector<internal::Segment>(data.segments, data.segments + data.positions_count + 1),
+    };
+    arrays.positions.push_back(std::numeric_limits<float>::infinity());
+    arrays.colors_on_marks.push_back(ColorRGBA{0.f, 0.f, 0.f, 0.f}); // Unused, it is only here so that all the arrays have the same size
+    return arrays;
+}
+
+auto PackedGradients::add(const Gradient& gradient) -> uint32_t
+{
+    const auto compiled = gradient.compile();
+    const auto data     = compiled.sampling_data();
+    const auto arrays   = packed_arrays(data);
+    _offsets.push_back(static_cast<uint32_t>(_positions.size()));
+    _positions_counts.push_back(static_cast<uint32_t>(data.positions_count));
+    _color_spaces.push_back(data.color_space);
+    _positions.insert(_positions.end(), arrays.positions.begin(), arrays.positions.end());
+    _colors_on_marks.insert(_colors_on_marks.end(), arrays.colors_on_marks.begin(), arrays.colors_on_marks.end());
+    _segments.insert(_segments.end(), arrays.segments.begin(), arrays.segments.end());
+    _max_positions_count = std::max(_max_positions_count, _positions_counts.back());
+    return static_cast<uint32_t>(_offsets.size() - 1);
+}
+
+/// Replaces `old_size` elements of `array` at `offset` with the ones of `values`.
+template<typename T>
+static void replace_range(std::vector<T>& array, size_t offset, size_t old_size, const std::vector<T>& values)
+{
+    const auto begin = array.begin() + static_cast<std::ptrdiff_t>(offset);
+    if (values.size() == old_size)
+    {
+        std::copy(values.begin(), values.end(), begin);
+        return;
+    }
+    array.insert(array.erase(begin, begin + static_cast<std::ptrdiff_t>(old_size)), values.begin(), values.end());
+}
+
+void PackedGradients::set(const uint32_t gradient_index, const Gradient& gradient)
+{
+    assert(gradient_index < size());
+    const auto   compiled = gradient.compile();
+    const auto   data     = compiled.sampling_data();
+    const auto   arrays   = packed_arrays(data);
+    const size_t offset   = _offsets[gradient_index];
+    const size_t old_size = _positions_counts[gradient_index] + size_t{1};
+
+    replace_range(_positions, offset, old_size, arrays.positions);
+    replace_range(_colors_on_marks, offset, old_size, arrays.colors_on_marks);
+    replace_range(_segments, offset, old_size, arrays.segments);
+    const auto old_positions_count    = _positions_counts[gradient_index];
+    _positions_counts[gradient_index] = static_cast<uint32_t>(data.positions_count);
+    _color_spaces[gradient_index]     = data.color_space;
+    for (size_t i = gradient_index + size_t{1}; i < _offsets.size(); ++i)
+        _offsets[i] = _offsets[i] - old_positions_count + _positions_counts[gradient_index];
+
+    if (old_positions_count == _max_positions_count || _positions_counts[gradient_index] > _max_positions_count)
+        update_max_positions_count();
+}
+
+void PackedGradients::clear()
+{
+    _offsets.clear();
+    _positions_counts.clear();
+    _color_spaces.clear();
+    _positions.clear();
+    _colors_on_marks.clear();
+    _segments.clear();
+    _max_positions_count = 0;
+}
+
+void PackedGradients::update_max_positions_count()
+{
+    _max_positions_count = _positions_counts.empty() ? 0 : *std::max_element(_positions_counts.begin(), _positions_counts.end());
+}
+
+auto PackedGradients::packed_sampling_data() const -> internal::PackedSamplingData
+{
+    auto data                = internal::PackedSamplingData{};
+    data.offsets             = _offsets.data();
+    data.positions_counts    = _positions_counts.data();
+    data.color_spaces        = _color_spaces.data();
+    data.positions           = _positions.data();
+    data.colors_on_marks     = _colors_on_marks.data();
+    data.segments            = _segments.data();
+    data.max_positions_count = _max_positions_count;
+    return data;
+}
+
+auto PackedGradients::at(const uint32_t gradient_index, const RelativePosition position) const -> ColorRGBA
+{
+    assert(gradient_index < size());
+    const auto  data = internal::sampling_data_of(packed_sampling_data(), gradient_index);
+    const float pos  = position.get();
+    return internal::from_color_space(internal::color_at(data, internal::segment_index(data, pos), pos), data.color_space);
+}
+
+void PackedGradients::sample(const uint32_t* gradient_indices, const float* positions, ColorRGBA* colors, const size_t count, const WrapMode wrap_mode) const
+{
+    static const internal::MultiSampleKernel kernel = internal::multi_sample_kernel(internal::best_instruction_set());
+    // The vectorized searches index the positions with 32-bit integers
+    const bool fits_in_int = _positions.size() < static_cast<size_t>(INT_MAX);
+    (fits_in_int ? kernel : &internal::multi_sample_scalar)(packed_sampling_data(), gradient_indices, positions, colors, count, wrap_mode);
+}
+
+void PackedGradients::sample_in_parallel(
+    const uint32_t* gradient_indices, const float* positions, ColorRGBA* colors, const size_t count, const WrapMode wrap_mode,
+    ThreadPool& thread_pool
+) const
+{
+    // Big enough that the cost of dispatching a chunk is negligible, small enough that there are many more chunks than threads,
+    // so that the threads that finish early can steal some work from the other ones.
+    static constexpr size_t chunk_size = 4096;
+    thread_pool.parallel_for((count + chunk_size - 1) / chunk_size, [&](size_t chunk) {
+        const size_t first = chunk * chunk_size;
+        sample(gradient_indices + first, positions + first, colors + first, std::min(chunk_size, count - first), wrap_mode);
+    });
+}
+
+} // namespace ImGG
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ColorRGBA.hpp"
+#include "ColorSpace.hpp"
+#include "RelativePosition.hpp"
+#include "SamplingData.hpp"
+#include "ThreadPool.hpp"
+#include "WrapMode.hpp"
+
+namespace ImGG {
+
+class Gradient;
+
+/// Many compiled gradients packed together, e.g. the color-over-lifetime gradients of all the emitters of a particle system.
+/// The arrays of all the gradients are stored one after the other in a few shared arrays (one for the positions of the marks, one for the segments, and so on),
+/// so that sampling many different gradients in a single pass stays in a few contiguous blocks of memory, instead of hopping between the `std::list`s of many `Gradient`s.
+/// It is not updated when the `Gradient`s change: call `set()` to replace one of them.
+class PackedGradients {
+public:
+    /// Compiles `gradient` and appends it. Returns its index, to pass to `at()` and `sample()`.
+    auto add(const Gradient& gradient) -> uint32_t;
+    /// Replaces gradient `gradient_index`, without changing the indices of the others.
+    /// The arrays of the gradients after it are moved when the number of marks changes.
+    void set(uint32_t gradient_index, const Gradient& gradient);
+    void clear();
+
+    auto size() const -> size_t { return _offsets.size(); }
+
+    /// Returns the same color as `CompiledGradient::at()` would for gradient `gradient_index`.
+    auto at(uint32_t gradient_index, RelativePosition position) const -> ColorRGBA;
+
+    /// Samples gradient `gradient_indices[i]` at `positions[i]`, for all `i` in [0, `count`), and writes the results in `colors`.
+    /// `positions` can be outside of the [0, 1] range, they are mapped back into it according to `wrap_mode`.
+    /// The searches in the marks are vectorized with AVX2 when the CPU supports it, which is detected at runtime.
+    void sample(const uint32_t* gradient_indices, const float* positions, ColorRGBA* colors, size_t count, WrapMode wrap_mode) const;
+    /// Same as `sample()`, but split into chunks that are sampled in parallel by the threads of `thread_pool`.
+    /// Each sample is computed independently of the others, so the result doesn't depend on the number of threads.
+    void sample_in_parallel(
+        const uint32_t* gradient_indices, const float* positions, ColorRGBA* colors, size_t count, WrapMode wrap_mode,
+        ThreadPool& thread_pool = default_thread_pool()
+    ) const;
+
+    /// Gives access to the raw arrays, e.g. to write your own sampling loops.
+    /// The view is invalidated when this `PackedGradients` is destroyed or modified.
+    auto packed_sampling_data() const -> internal::PackedSamplingData;
+
+private:
+    void update_max_positions_count();
+
+private:
+    // See `internal::PackedSamplingData` for the meaning of these arrays.
+    std::vector<uint32_t>          _offsets{};
+    std::vector<uint32_t>          _positions_counts{};
+    std::vector<ColorSpace>        _color_spaces{};
+    std::vector<float>             _positions{};
+    std::vector<ColorRGBA>         _colors_on_marks{};
+    std::vector<internal::Segment> _segments{};
+    uint32_t                       _max_positions_count{0};
+};
+
+} // namespace ImGG
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+
+namespace ImGG {
+
+/// A range of rows of a table (e.g. of a `KeyframedBake` or a `GradientAtlas`), from `begin` (included) to `end` (excluded). Empty when `begin == end`.
+struct RowRange {
+    size_t begin;
+    size_t end;
+};
+
+} // namespace ImGG
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include "ColorRGBA.hpp"
+#include "ColorSpace.hpp"
+
+namespace ImGG { namespace internal {
+
+/// Remaps the position `t` (from 0 to 1) inside a segment so that the color is halfway between the two marks at `t == midpoint` instead of `t == 0.5`.
+/// The curve is `t * (1 - midpoint) / (midpoint + t * (1 - 2 * midpoint))`. Unlike the usual power curve it costs a single division,
+/// and its coefficients are computed once, when the midpoint is set. A midpoint of 0.5 gives back exactly `t`.
+struct MidpointBias {
+    MidpointBias() = default;
+    explicit MidpointBias(float midpoint)
+    {
+        midpoint = std::min(std::max(midpoint, 0.01f), 0.99f); // The extreme midpoints would squash the whole segment into a hard edge on one of the marks
+        scale    = 1.f - midpoint;
+        offset   = midpoint;
+        slope    = 1.f - 2.f * midpoint;
+    }
+
+    auto operator()(float t) const -> float
+    {
+        if (slope == 0.f) // The midpoint is 0.5, there is nothing to remap
+            return t;
+        return t * scale / (offset + t * slope);
+    }
+
+    /// The `t` that is remapped to `biased_t`.
+    auto inverse(float biased_t) const -> float
+    {
+        if (slope == 0.f)
+            return biased_t;
+        return biased_t * offset / (scale - biased_t * slope);
+    }
+
+    float scale{0.5f};
+    float offset{0.5f};
+    float slope{0.f};
+};
+
+/// The part of the gradient that lies between two consecutive marks.
+/// The color at `position` is `color + t * (slope + t * (quadratic + t * cubic))`, with `t = bias((position - start) * inverse_width)`.
+/// `quadratic` and `cubic` are only used by `Interpolation::Cubic`, and are 0 for the other modes.
+struct Segment {
+    float        start{0.f};
+    float        inverse_width{0.f};
+    MidpointBias bias{};
+    ColorRGBA    color{0.f, 0.f, 0.f, 1.f};
+    ColorRGBA    slope{0.f, 0.f, 0.f, 0.f};
+    ColorRGBA    quadratic{0.f, 0.f, 0.f, 0.f};
+    ColorRGBA    cubic{0.f, 0.f, 0.f, 0.f};
+};
+
+/// A non-owning view of the arrays of a `CompiledGradient`, that can be passed to the sampling kernels.
+struct SamplingData {
+    /// The distinct positions of the marks, sorted.
+    const float* positions{nullptr};
+    size_t       positions_count{0};
+    /// The color to return when sampling exactly on `positions[i]`.
+    const ColorRGBA* colors_on_marks{nullptr};
+    /// There are `positions_count + 1` segments: `segments[i]` covers everything between `positions[i - 1]` and `positions[i]`.
+    const Segment* segments{nullptr};
+    /// All the colors above are in this color space, so that the segments are straight lines.
+    /// Use `from_color_space()` to convert the sampled colors back to sRGB.
+    ColorSpace color_space{ColorSpace::sRGB};
+};
+
+/// A non-owning view of the arrays of a `PackedGradients`: the arrays of the `SamplingData` of all its gradients, one after the other.
+struct PackedSamplingData {
+    /// The arrays of gradient `g` start at `offsets[g]` in `positions`, `colors_on_marks` and `segments`.
+    /// It has `positions_counts[g]` positions followed by +infinity, so that a search in an empty gradient stops right away,
+    /// `positions_counts[g] + 1` segments, and as many colors on its marks, the last one being unused.
+    const uint32_t*   offsets{nullptr};
+    const uint32_t*   positions_counts{nullptr};
+    const ColorSpace* color_spaces{nullptr};
+    const float*      positions{nullptr};
+    const ColorRGBA*  colors_on_marks{nullptr};
+    const Segment*    segments{nullptr};
+    /// The biggest of the `positions_counts`, which tells how many steps a binary search needs in the worst case.
+    uint32_t max_positions_count{0};
+};
+
+/// The arrays of gradient `gradient_index` of `data`.
+inline auto sampling_data_of(const PackedSamplingData& data, uint32_t gradient_index) -> SamplingData
+{
+    const uint32_t offset  = data.offsets[gradient_index];
+    auto           result  = SamplingData{};
+    result.positions       = data.positions + offset;
+    result.positions_count = data.positions_counts[gradient_index];
+    result.colors_on_marks = data.colors_on_marks + offset;
+    result.segments        = data.segments + offset;
+    result.color_space     = data.color_spaces[gradient_index];
+    return result;
+}
+
+/// A non-owning view of the arrays of a `StepGradient`, that can be passed to the step kernels.
+struct StepData {
+    /// The distinct positions of the marks, sorted, followed by +infinity so that there is always a position after the last segment.
+    const float* positions{nullptr};
+    size_t       positions_count{0}; // Without the +infinity
+    /// The [0, 1] range is cut into cells of the same width, and `cells[c]` is the index of the first segment that overlaps cell `c` (see `step_cell()`).
+    const uint32_t* cells{nullptr};
+    float           cells_count{1.f};
+    /// No cell contains more marks than this, so that going from `cells[c]` to the segment of any position of cell `c` takes at most that many steps.
+    uint32_t max_marks_per_cell{0};
+    /// `palette_indices[2 * i]` is the index in the palette of the color of segment `i`, and `palette_indices[2 * i + 1]` is the one of the color exactly on the position of mark `i`.
+    const uint32_t* palette_indices{nullptr};
+};
+
+/// The cell of `position`, which must be in the [0, 1] range. NaNs go to the last cell.
+inline auto step_cell(const StepData& data, float position) -> uint32_t
+{
+    const float cell      = position * data.cells_count;
+    const float last_cell = data.cells_count - 1.f;
+    return static_cast<uint32_t>(cell < last_cell ? cell : last_cell);
+}
+
+/// The index in the palette of the color at `position`, whose cell is `cell`.
+inline auto step_palette_index(const StepData& data, uint32_t cell, float position) -> uint32_t
+{
+    uint32_t index = data.cells[cell];
+    while (data.positions[index] < position) // Stops on the +infinity at the latest
+    {
+        ++index;
+    }
+    return data.palette_indices[2 * index + (data.positions[index] == position ? 1 : 0)];
+}
+
+/// Where `position` is inside `segment`, from 0 on its start to 1 on its end, remapped by its midpoint.
+inline auto segment_t(const Segment& segment, float position) -> float
+{
+    return segment.bias((position - segment.start) * segment.inverse_width);
+}
+
+/// Index of the segment that contains `position`, which is also the number of marks that are strictly before `position`.
+inline auto segment_index(const SamplingData& data, float position) -> size_t
+{
+    return static_cast<size_t>(std::lower_bound(data.positions, data.positions + data.positions_count, position) - data.positions);
+}
+
+}} // namespace ImGG::internal
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+
+namespace ImGG { namespace internal {
+
+/// A vector that stores up to `inline_capacity` elements inside of itself, and only allocates on the heap when it grows bigger than that.
+/// Constructing, copying and moving a small one never allocates.
+/// It only supports trivially copyable types, so that the elements can be moved around with `memcpy()` and never need to be destroyed.
+template<typename T, size_t inline_capacity>
+class SmallVector {
+    static_assert(std::is_trivially_copyable<T>::value, "SmallVector only supports trivially copyable types");
+    static_assert(inline_capacity > 0, "Use a std::vector if you don't want any inline storage");
+
+public:
+    using value_type      = T;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = T&;
+    using const_reference = const T&;
+    using pointer         = T*;
+    using const_pointer   = const T*;
+    using iterator        = T*;
+    using const_iterator  = const T*;
+
+    SmallVector() = default;
+    SmallVector(std::initializer_list<T> values)
+        : SmallVector(values.begin(), values.end())
+    {}
+    template<typename InputIterator>
+    SmallVector(InputIterator first, InputIterator last)
+    {
+        for (; first != last; ++first)
+            push_back(*first);
+    }
+
+    SmallVector(const SmallVector& other)
+    {
+        reserve(other._size);
+        copy_elements(_data, other._data, other._size);
+        _size = other._size;
+    }
+    SmallVector(SmallVector&& other) noexcept
+    {
+        steal(other);
+    }
+    SmallVector& operator=(const SmallVector& other)
+    {
+        if (this != &other)
+        {
+            _size = 0; // Nothing to copy while reserving
+            reserve(other._size);
+            copy_elements(_data, other._data, other._size);
+            _size = other._size;
+        }
+        return *this;
+    }
+    SmallVector& operator=(SmallVector&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            steal(other);
+        }
+        return *this;
+    }
+    ~SmallVector() { release(); }
+
+    auto begin() -> iterator { return _data; }
+    auto begin() const -> const_iterator { return _data; }
+    auto end() -> iterator { return _data + _size; }
+    auto end() const -> const_iterator { return _data + _size; }
+    auto data() -> T* { return _data; }
+    auto data() const -> const T* { return _data; }
+
+    auto size() const -> size_t { return _size; }
+    auto capacity() const -> size_t { return _capacity; }
+    auto empty() const -> bool { return _size == 0; }
+    /// True iff the elements are stored inside of the `SmallVector` itself.
+    auto is_inline() const -> bool { return _data == inline_data(); }
+
+    auto operator[](size_t index) -> T&
+    {
+        assert(index < _size);
+        return _data[index];
+    }
+    auto operator[](size_t index) const -> const T&
+    {
+        assert(index < _size);
+        return _data[index];
+    }
+    auto front() -> T& { return (*this)[0]; }
+    auto front() const -> const T& { return (*this)[0]; }
+    auto back() -> T& { return (*this)[_size - 1]; }
+    auto back() const -> const T& { return (*this)[_size - 1]; }
+
+    void reserve(size_t capacity)
+    {
+        if (capacity <= _capacity)
+            return;
+        T* const     new_data = static_cast<T*>(::operator new(capacity * sizeof(T)));
+        const size_t size     = _size;
+        copy_elements(new_data, _data, size);
+        release();
+        _data     = new_data;
+        _size     = size;
+        _capacity = capacity;
+    }
+
+    void push_back(const T& value) { insert(end(), value); }
+
+    auto insert(const_iterator position, const T& value) -> iterator
+    {
+        const auto index = static_cast<size_t>(position - _data);
+        assert(index <= _size);
+        const T copy = value; // `value` might be one of our elements, which are invalidated by `reserve()` and shifted by `memmove()`
+        if (_size == _capacity)
+            reserve(_capacity * 2);
+        std::memmove(static_cast<void*>(_data + index + 1), _data + index, (_size - index) * sizeof(T));
+        new (_data + index) T(copy);
+        ++_size;
+        return _data + index;
+    }
+
+    auto erase(const_iterator position) -> iterator
+    {
+        const auto index = static_cast<size_t>(position - _data);
+        assert(index < _size);
+        std::memmove(static_cast<void*>(_data + index), _data + index + 1, (_size - index - 1) * sizeof(T));
+        --_size;
+        return _data + index;
+    }
+
+    /// Keeps the capacity, so that the vector can grow back without allocating again.
+    void clear() { _size = 0; }
+
+    friend auto operator==(const SmallVector& a, const SmallVector& b) -> bool { return a._size == b._size && std::equal(a.begin(), a.end(), b.begin()); }
+    friend auto operator!=(const SmallVector& a, const SmallVector& b) -> bool { return !(a == b); }
+
+private:
+    auto inline_data() -> T* { return reinterpret_cast<T*>(_inline_storage); }
+    auto inline_data() const -> const T* { return reinterpret_cast<const T*>(_inline_storage); }
+
+    static void copy_elements(T* destination, const T* source, size_t count)
+    {
+        if (count != 0)
+            std::memcpy(static_cast<void*>(destination), source, count * sizeof(T));
+    }
+
+    /// Frees the heap storage, if any. The elements are lost.
+    void release()
+    {
+        if (!is_inline())
+            ::operator delete(_data);
+        _data     = inline_data();
+        _capacity = inline_capacity;
+        _size     = 0;
+    }
+
+    /// Takes the elements of `other` and leaves it empty. `*this` must be empty and not have any heap storage.
+    void steal(SmallVector& other)
+    {
+        if (other.is_inline())
+        {
+            copy_elements(_data, other._data, other._size);
+            _size = other._size;
+        }
+        else
+        {
+            _data     = other._data;
+            _size     = other._size;
+            _capacity = other._capacity;
+        }
+        other._data     = other.inline_data();
+        other._size     = 0;
+        other._capacity = inline_capacity;
+    }
+
+private:
+    alignas(T) unsigned char _inline_storage[inline_capacity * sizeof(T)];
+    T*                       _data{inline_data()};
+    size_t                   _size{0};
+    size_t                   _capacity{inline_capacity};
+};
+
+}} // namespace ImGG
@@ -0,0 +1,128 @@
+#include "StepGradient.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <limits>
+#include <map>
+#include "Gradient.hpp"
+#include "color_conversions.hpp"
+#include "sample_kernels.hpp"
+
+namespace ImGG {
+
+// There are a few cells per mark, so that most cells don't contain any mark and their positions don't need any comparison.
+// The number of cells is a power of 2 so that the multiplication by it is exact, and the cells have exactly the same boundaries as `k / cells_count`.
+static constexpr size_t cells_per_mark  = 4;
+static constexpr size_t min_cells_count = 16;
+static constexpr size_t max_cells_count = size_t{1} << 16;
+
+static auto cells_count_for(size_t marks_count) -> size_t
+{
+    size_t cells_count = min_cells_count;
+    while (cells_count < marks_count * cells_per_mark && cells_count < max_cells_count)
+        cells_count *= 2;
+    return cells_count;
+}
+
+StepGradient::StepGradient()
+    : StepGradient{CompiledGradient{}}
+{}
+
+StepGradient::StepGradient(const Gradient& gradient)
+    : StepGradient{gradient.compile()}
+{}
+
+StepGradient::StepGradient(const CompiledGradient& gradient)
+{
+    assert(gradient.interpolation_mode() == Interpolation::Constant && "A StepGradient can only be built from an Interpolation::Constant gradient");
+    const auto data = gradient.sampling_data();
+
+    _positions.assign(data.positions, data.positions + data.positions_count);
+    _positions.push_back(std::numeric_limits<float>::infinity());
+
+    // Store each distinct color once, in the order in which they appear.
+    std::map<std::array<float, 4>, uint32_t> known_colors;
+
+    const auto palette_index_of = [&](const ColorRGBA& color_in_color_space) -> uint32_t {
+        const ColorRGBA color  = internal::from_color_space(color_in_color_space, data.color_space); // The same conversion as `CompiledGradient::at()`, so that we give exactly the same colors
+        const auto      result = known_colors.insert({{color.x, color.y, color.z, color.w}, static_cast<uint32_t>(_palette.size())});
+        if (result.second)
+        {
+            _palette.push_back(color);
+            _palette_rgba8.push_back(internal::pack_rgba8(color));
+        }
+        return result.first->second;
+    };
+    _palette_indices.reserve(2 * (data.positions_count + 1));
+    for (size_t i = 0; i <= data.positions_count; ++i)
+    {
+        _palette_indices.push_back(palette_index_of(data.segments[i].color)); // The segments of Interpolation::Constant are uniform
+        _palette_indices.push_back(i < data.positions_count ? palette_index_of(data.colors_on_marks[i]) : _palette_indices.back()); // There is no mark after the last segment
+    }
+
+    // `cells[c]` is the number of marks that are in the cells before `c`. `step_cell()` never decreases when the position increases,
+    // so these marks are all strictly before the positions of cell `c`, and the marks of the next cells are all after them.
+    const size_t cells_count = cells_count_for(data.positions_count);
+    auto         step        = internal::StepData{};
+    step.cells_count         = static_cast<float>(cells_count);
+    std::vector<uint32_t> marks_per_cell(cells_count, 0);
+    for (size_t i = 0; i < data.positions_count; ++i)
+        ++marks_per_cell[internal::step_cell(step, data.positions[i])];
+    _cells.resize(cells_count);
+    uint32_t marks_before = 0;
+    for (size_t cell = 0; cell < cells_count; ++cell)
+    {
+        _cells[cell] = marks_before;
+        marks_before += marks_per_cell[cell];
+        _max_marks_per_cell = std::max(_max_marks_per_cell, marks_per_cell[cell]);
+    }
+}
+
+auto StepGradient::step_data() const -> internal::StepData
+{
+    auto data               = internal::StepData{};
+    data.positions          = _positions.data();
+    data.positions_count    = _positions.size() - 1;
+    data.cells              = _cells.data();
+    data.cells_count        = static_cast<float>(_cells.size());
+    data.max_marks_per_cell = _max_marks_per_cell;
+    data.palette_indices    = _palette_indices.data();
+    return data;
+}
+
+void StepGradient::sample_indices(const float* positions, uint32_t* palette_indices, const size_t count, const WrapMode wrap_mode) const
+{
+    static const internal::StepKernel kernel = internal::step_kernel(internal::best_instruction_set());
+    kernel(step_data(), positions, palette_indices, count, wrap_mode);
+}
+
+template<typename Output>
+void StepGradient::sample_by_chunks(const float* positions, const size_t count, const WrapMode wrap_mode, Output&& output) const
+{
+    static constexpr size_t chunk_size = 256;
+    uint32_t                indices[chunk_size];
+    for (size_t first = 0; first < count; first += chunk_size)
+    {
+        const size_t chunk_count = std::min(chunk_size, count - first);
+        sample_indices(positions + first, indices, chunk_count, wrap_mode);
+        output(first, indices, chunk_count);
+    }
+}
+
+void StepGradient::sample(const float* positions, ColorRGBA* colors, const size_t count, const WrapMode wrap_mode) const
+{
+    sample_by_chunks(positions, count, wrap_mode, [&](size_t first, const uint32_t* indices, size_t chunk_count) {
+        for (size_t i = 0; i < chunk_count; ++i)
+            colors[first + i] = _palette[indices[i]];
+    });
+}
+
+void StepGradient::sample_rgba8(const float* positions, ImU32* colors, const size_t count, const WrapMode wrap_mode) const
+{
+    sample_by_chunks(positions, count, wrap_mode, [&](size_t first, const uint32_t* indices, size_t chunk_count) {
+        for (size_t i = 0; i < chunk_count; ++i)
+            colors[first + i] = _palette_rgba8[indices[i]];
+    });
+}
+
+} // namespace ImGG
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ColorRGBA.hpp"
+#include "CompiledGradient.hpp"
+#include "RelativePosition.hpp"
+#include "SamplingData.hpp"
+#include "WrapMode.hpp"
+
+namespace ImGG {
+
+class Gradient;
+
+/// A read-only snapshot of an `Interpolation::Constant` gradient, i.e. of a step function, e.g. for discrete palettes and classification maps.
+/// Its distinct colors are stored once in a palette, and sampling a position gives the index of its color in that palette, without any interpolation math.
+/// Instead of searching the marks, the position is quantized into a table of cells that stores the first segment of each cell,
+/// so each sample is a single lookup followed by a few comparisons at most (only when marks fall inside its cell).
+/// It samples with the same rules as `CompiledGradient::at()`, including on the marks themselves, and gives exactly the same colors.
+class StepGradient {
+public:
+    /// Black everywhere, like an empty `Gradient`.
+    StepGradient();
+    /// `gradient.interpolation_mode()` must be `Interpolation::Constant`.
+    explicit StepGradient(const Gradient& gradient);
+    /// `gradient.interpolation_mode()` must be `Interpolation::Constant`.
+    explicit StepGradient(const CompiledGradient& gradient);
+
+    /// Returns the same color as `CompiledGradient::at()` would.
+    auto at(RelativePosition position) const -> ColorRGBA { return _palette[palette_index(position)]; }
+    /// The index in `palette()` of the color at `position`.
+    auto palette_index(RelativePosition position) const -> uint32_t
+    {
+        const auto data = step_data();
+        return internal::step_palette_index(data, internal::step_cell(data, position.get()), position.get());
+    }
+
+    /// The distinct colors of the gradient, in sRGB, in the order in which they appear from position 0 to position 1.
+    auto palette() const -> const std::vector<ColorRGBA>& { return _palette; }
+    /// Same as `palette()`, but packed as 8-bit RGBA, like `ImGui::ColorConvertFloat4ToU32()` does.
+    auto palette_rgba8() const -> const std::vector<ImU32>& { return _palette_rgba8; }
+
+    /// Writes in `palette_indices` the index in `palette()` of the color at each of the `count` `positions`, e.g. to label an image.
+    /// `positions` can be outside of the [0, 1] range, they are mapped back into it according to `wrap_mode`.
+    /// This uses the fastest SIMD instruction set (SSE2, AVX2 or NEON) that the CPU supports, which is detected at runtime.
+    void sample_indices(const float* positions, uint32_t* palette_indices, size_t count, WrapMode wrap_mode) const;
+    /// Same as `sample_indices()`, but writes the colors.
+    void sample(const float* positions, ColorRGBA* colors, size_t count, WrapMode wrap_mode) const;
+    /// Same as `sample_indices()`, but writes the colors packed as 8-bit RGBA.
+    void sample_rgba8(const float* positions, ImU32* colors, size_t count, WrapMode wrap_mode) const;
+
+    /// Gives access to the raw arrays, e.g. to write your own sampling loops.
+    /// The view is invalidated when this `StepGradient` is destroyed or modified.
+    auto step_data() const -> internal::StepData;
+
+private:
+    /// Calls `output(first, indices, count)` on chunks of the palette indices of the `positions`, while they are still in the cache.
+    template<typename Output>
+    void sample_by_chunks(const float* positions, size_t count, WrapMode wrap_mode, Output&& output) const;
+
+private:
+    // See `internal::StepData` for the meaning of these arrays.
+    std::vector<float>     _positions{};
+    std::vector<uint32_t>  _cells{};
+    uint32_t               _max_marks_per_cell{0};
+    std::vector<uint32_t>  _palette_indices{};
+    std::vector<ColorRGBA> _palette{};
+    std::vector<ImU32>     _palette_rgba8{};
+};
+
+} // namespace ImGG
@@ -0,0 +1,145 @@
+#include "ThreadPool.hpp"
+#include <cassert>
+
+namespace ImGG {
+
+/// The pool whose tasks the current thread is running, if any. Only used to catch the calls to `parallel_for()` from one of its own tasks.
+static thread_local const ThreadPool* running_pool = nullptr;
+
+static auto actual_threads_count(size_t threads_count) -> size_t
+{
+    if (threads_count != 0)
+        return threads_count;
+    const unsigned int cores_count = std::thread::hardware_concurrency();
+    return cores_count != 0 ? cores_count : 1; // hardware_concurrency() returns 0 when it doesn't know
+}
+
+ThreadPool::ThreadPool(size_t threads_count)
+{
+    threads_count = actual_threads_count(threads_count);
+    for (size_t i = 0; i < threads_count; ++i)
+    {
+        _queues.emplace_back(new Queue{});
+    }
+    for (size_t i = 1; i < threads_count; ++i)
+    {
+        _threads.emplace_back([this, i]() { worker_thread(i); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _should_stop = true;
+    }
+    _job_available.notify_all();
+    for (auto& thread : _threads)
+    {
+        thread.join();
+    }
+}
+
+void ThreadPool::parallel_for(size_t tasks_count, const std::function<void(size_t)>& task)
+{
+    assert(running_pool != this && "parallel_for() can't be called from a task of the same pool, it would deadlock");
+    std::lock_guard<std::mutex> parallel_for_lock{_parallel_for_mutex};
+
+    // Give each thread a contiguous share of the tasks
+    const size_t queues_count = _queues.size();
+    for (size_t i = 0; i < queues_count; ++i)
+    {
+        Queue&                      queue = *_queues[i];
+        std::lock_guard<std::mutex> lock{queue.mutex};
+        queue.begin = tasks_count * i / queues_count;
+        queue.end   = tasks_count * (i + 1) / queues_count;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _task        = &task;
+        _job_is_open = true;
+        ++_job_id;
+    }
+    _job_available.notify_all();
+
+    run_tasks(0);
+
+    // All the queues are empty, but the other threads might still be running the last tasks they took.
+    std::unique_lock<std::mutex> lock{_mutex};
+    _worker_finished.wait(lock, [&]() { return _active_workers == 0; });
+    _job_is_open = false; // Done while holding the lock, so that no late worker can join this job anymore
+    _task        = nullptr;
+}
+
+void ThreadPool::worker_thread(size_t queue_index)
+{
+    size_t last_job_id = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock{_mutex};
+            _job_available.wait(lock, [&]() { return _should_stop || (_job_is_open && _job_id != last_job_id); });
+            if (_should_stop)
+                return;
+            last_job_id = _job_id;
+            ++_active_workers;
+        }
+
+        run_tasks(queue_index);
+
+        {
+            std::lock_guard<std::mutex> lock{_mutex};
+            --_active_workers;
+        }
+        _worker_finished.notify_all();
+    }
+}
+
+void ThreadPool::run_tasks(size_t queue_index)
+{
+    const std::function<void(size_t)>& task = *_task; // Can't change while this job is open, i.e. while we are running
+
+    const ThreadPool* const previous_pool = running_pool; // A task can use another pool
+    running_pool                          = this;
+    size_t task_index{};
+    while (pop_task(queue_index, task_index) || steal_task(queue_index, task_index))
+    {
+        task(task_index);
+    }
+    running_pool = previous_pool;
+}
+
+auto ThreadPool::pop_task(size_t queue_index, size_t& task_index) -> bool
+{
+    Queue&                      queue = *_queues[queue_index];
+    std::lock_guard<std::mutex> lock{queue.mutex};
+    if (queue.begin == queue.end)
+        return false;
+    task_index = queue.begin++;
+    return true;
+}
+
+auto ThreadPool::steal_task(size_t thief_index, size_t& task_index) -> bool
+{
+    // Steal from the back of the queues, so that we don't compete with their owner, which takes tasks from the front.
+    for (size_t offset = 1; offset < _queues.size(); ++offset)
+    {
+        Queue&                      queue = *_queues[(thief_index + offset) % _queues.size()];
+        std::lock_guard<std::mutex> lock{queue.mutex};
+        if (queue.begin != queue.end)
+        {
+            task_index = --queue.end;
+            return true;
+        }
+    }
+    return false;
+}
+
+auto default_thread_pool() -> ThreadPool&
+{
+    static ThreadPool thread_pool{};
+    return thread_pool;
+}
+
+} // namespace ImGG
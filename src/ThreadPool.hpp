@@ -0,0 +1,65 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ImGG {
+
+/// A fixed set of threads that can run the iterations of a loop in parallel.
+/// Each thread starts with its own share of the iterations, and steals from the other threads once it is done with its own.
+class ThreadPool {
+public:
+    /// `threads_count` includes the thread that calls `parallel_for()`, which also does some of the work.
+    /// 0 means one thread per core.
+    explicit ThreadPool(size_t threads_count = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&)                 = delete;
+    ThreadPool& operator=(ThreadPool&&)      = delete;
+
+    /// Calls `task(i)` for every `i` in [0, `tasks_count`), spread across the threads, and returns once they are all done.
+    /// If several threads call it at the same time, the calls are executed one after the other.
+    /// So it must not be called from a `task` running on the same pool: it would wait forever for the call that is running that task.
+    void parallel_for(size_t tasks_count, const std::function<void(size_t)>& task);
+
+    auto threads_count() const -> size_t { return _queues.size(); }
+
+private:
+    struct Queue {
+        std::mutex mutex{};
+        size_t     begin{0};
+        size_t     end{0};
+    };
+
+    void worker_thread(size_t queue_index);
+    /// Runs tasks until there are none left in any of the queues.
+    void run_tasks(size_t queue_index);
+    auto pop_task(size_t queue_index, size_t& task_index) -> bool;
+    auto steal_task(size_t thief_index, size_t& task_index) -> bool;
+
+private:
+    std::vector<std::unique_ptr<Queue>> _queues{}; // Queue 0 belongs to the thread that calls `parallel_for()`
+    std::vector<std::thread>            _threads{};
+
+    std::mutex                             _parallel_for_mutex{}; // Only one `parallel_for()` at a time
+    std::mutex                             _mutex{};              // Protects all the members below
+    std::condition_variable                _job_available{};
+    std::condition_variable                _worker_finished{};
+    const std::function<void(size_t)>*     _task{nullptr};
+    size_t                                 _job_id{0};
+    bool                                   _job_is_open{false};
+    size_t                                 _active_workers{0};
+    bool                                   _should_stop{false};
+};
+
+/// A pool with one thread per core, created the first time it is used.
+auto default_thread_pool() -> ThreadPool&;
+
+} // namespace ImGG
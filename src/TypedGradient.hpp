@@ -0,0 +1,201 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+#include "BasicColorRGBA.hpp"
+#include "Gradient.hpp"
+#include "Interpolation.hpp"
+#include "WrapMode.hpp"
+
+namespace ImGG {
+
+template<typename Color, typename Position = float>
+struct TypedMark {
+    Position position;
+    Color    color;
+};
+
+namespace internal {
+
+/// Same as `RelativePosition{position, wrap_mode}`, for any floating point type.
+template<typename Position>
+auto wrap_position(Position position, WrapMode wrap_mode) -> Position
+{
+    switch (wrap_mode)
+    {
+    case WrapMode::Clamp:
+        return std::min(std::max(position, Position{0}), Position{1});
+    case WrapMode::Repeat:
+        return position - std::floor(position);
+    case WrapMode::MirrorRepeat:
+    {
+        const Position half = position / Position{2};
+        return Position{1} - std::abs((half - std::floor(half)) * Position{2} - Position{1});
+    }
+    default:
+        assert(false && "[ImGuiGradient::wrap_position] Invalid enum value");
+        return Position{0};
+    }
+}
+
+/// The color between the marks `lower` and `upper`, at `t` (between 0 and 1).
+template<Interpolation interpolation_mode>
+struct TypedInterpolation;
+
+template<>
+struct TypedInterpolation<Interpolation::Linear> {
+    template<typename Color, typename Position>
+    static auto interpolate(const Color& lower, const Color& upper, Position t) -> Color
+    {
+        return ColorTraits<Color>::lerp(lower, upper, t);
+    }
+};
+
+template<>
+struct TypedInterpolation<Interpolation::Constant> {
+    template<typename Color, typename Position>
+    static auto interpolate(const Color&, const Color& upper, Position) -> Color
+    {
+        return upper;
+    }
+};
+
+} // namespace internal
+
+/// A read-only gradient whose colors are stored as `Color`s (e.g. `ColorRGBA8`, `ColorRGBAf`, `ColorRGBAd` or `ColorRGBA`) and whose positions are stored as `Position`s (`float` or `double`).
+/// The colors are interpolated directly in the `Color` type, so `at()` returns them without any conversion, e.g. 8-bit colors for a UI or doubles for scientific work.
+/// This means that they can only be interpolated in sRGB, and only linearly or with constant steps: check `can_represent()` before building one from a `Gradient`.
+/// It samples with the same rules as `Gradient::at()`, including on the marks themselves.
+template<typename Color, typename Position = float>
+class TypedGradient {
+    static_assert(std::is_floating_point<Position>::value, "The positions must be floats or doubles");
+
+public:
+    using Mark = TypedMark<Color, Position>;
+
+    /// Black to white, like a default `Gradient`.
+    TypedGradient()
+        : TypedGradient{Gradient{}}
+    {}
+
+    /// Converts the colors of all the marks of `gradient` to `Color`. `can_represent(gradient)` must be true.
+    explicit TypedGradient(const Gradient& gradient)
+        : TypedGradient{converted_marks(gradient), gradient.interpolation_mode()}
+    {}
+
+    /// The positions of the `marks` must be between 0 and 1, but they don't need to be sorted.
+    /// `interpolation_mode` can't be `Interpolation::Cubic`.
+    TypedGradient(std::vector<Mark> marks, Interpolation interpolation_mode)
+        : _interpolation_mode{interpolation_mode}
+    {
+        assert(interpolation_mode != Interpolation::Cubic && "TypedGradient doesn't support Interpolation::Cubic");
+        std::stable_sort(marks.begin(), marks.end(), [](const Mark& a, const Mark& b) { return a.position < b.position; });
+        for (const Mark& mark : marks)
+        {
+            assert(mark.position >= Position{0} && mark.position <= Position{1} && "The positions must be between 0 and 1");
+            if (_positions.empty() || _positions.back() != mark.position) // When several marks share the same position, only the first one is ever used by `Gradient::at()`.
+            {
+                _positions.push_back(mark.position);
+                _colors.push_back(mark.color);
+            }
+        }
+        _inverse_widths.push_back(Position{0});
+        for (size_t i = 1; i < _positions.size(); ++i)
+            _inverse_widths.push_back(Position{1} / (_positions[i] - _positions[i - 1]));
+        for (size_t i = 0; i < _positions.size(); ++i)
+            _colors_on_marks.push_back(color_on_mark(i));
+    }
+
+    /// `position` must be between 0 and 1.
+    auto at(Position position) const -> Color
+    {
+        switch (_interpolation_mode)
+        {
+        case Interpolation::Linear:
+            return at<Interpolation::Linear>(position);
+        case Interpolation::Constant:
+            return at<Interpolation::Constant>(position);
+        default:
+            assert(false && "[ImGuiGradient::TypedGradient::at] Invalid enum value");
+            return black();
+        }
+    }
+
+    /// `position` can be outside of the [0, 1] range, it is mapped back into it according to `wrap_mode`.
+    auto at(Position position, WrapMode wrap_mode) const -> Color
+    {
+        return at(internal::wrap_position(position, wrap_mode));
+    }
+
+    /// Same as `at()`, but the interpolation mode is known at compile time. It must be the same as `interpolation_mode()`.
+    template<Interpolation interpolation_mode>
+    auto at(Position position) const -> Color
+    {
+        assert(interpolation_mode == _interpolation_mode && "The interpolation mode doesn't match the one of the gradient");
+        const auto index = static_cast<size_t>(std::lower_bound(_positions.begin(), _positions.end(), position) - _positions.begin());
+        if (index < _positions.size() && _positions[index] == position)
+            return _colors_on_marks[index];
+        if (index == 0)
+            return _colors.empty() ? black() : _colors.front();
+        if (index == _positions.size())
+            return _colors.back();
+        return internal::TypedInterpolation<interpolation_mode>::interpolate(_colors[index - 1], _colors[index], (position - _positions[index - 1]) * _inverse_widths[index]);
+    }
+
+    /// False iff `gradient` uses a feature that a `TypedGradient` doesn't support, and so can't be converted to one:
+    /// `Interpolation::Cubic`, a `Gradient::color_space()` other than `ColorSpace::sRGB`, or a `Mark::midpoint` other than 0.5.
+    static auto can_represent(const Gradient& gradient) -> bool { return !gradient.is_curved(); }
+
+    auto interpolation_mode() const -> Interpolation { return _interpolation_mode; }
+    /// The distinct positions of the marks, sorted.
+    auto positions() const -> const std::vector<Position>& { return _positions; }
+    /// The color of the mark at each of the `positions()`.
+    auto colors() const -> const std::vector<Color>& { return _colors; }
+
+private:
+    static auto black() -> Color
+    {
+        return internal::ColorTraits<Color>::from_rgba(ColorRGBA{0.f, 0.f, 0.f, 1.f});
+    }
+
+    static auto converted_marks(const Gradient& gradient) -> std::vector<Mark>
+    {
+        assert(can_represent(gradient) && "TypedGradient doesn't support Interpolation::Cubic, color spaces other than sRGB, nor midpoints");
+        std::vector<Mark> marks;
+        for (const ImGG::Mark& mark : gradient.get_marks())
+            marks.push_back(Mark{static_cast<Position>(mark.position.get()), internal::ColorTraits<Color>::from_rgba(mark.color)});
+        return marks;
+    }
+
+    /// Sampling exactly on a mark ignores it, and uses the marks around it (see `Gradient::at()`).
+    auto color_on_mark(size_t index) const -> Color
+    {
+        const bool has_lower = index > 0;
+        const bool has_upper = index + 1 < _positions.size();
+        if (!has_lower && !has_upper)
+            return black();
+        if (!has_lower)
+            return _colors[index + 1];
+        if (!has_upper)
+            return _colors[index - 1];
+        if (_interpolation_mode == Interpolation::Constant)
+            return _colors[index + 1];
+        return internal::ColorTraits<Color>::lerp(_colors[index - 1], _colors[index + 1], (_positions[index] - _positions[index - 1]) / (_positions[index + 1] - _positions[index - 1]));
+    }
+
+private:
+    std::vector<Position> _positions{};
+    std::vector<Color>    _colors{};
+    std::vector<Color>    _colors_on_marks{}; // What `at()` returns when sampling exactly on each of the positions
+    std::vector<Position> _inverse_widths{};  // `_inverse_widths[i]` is 1 / (`_positions[i]` - `_positions[i - 1]`)
+    Interpolation         _interpolation_mode{Interpolation::Linear};
+};
+
+using GradientRGBA8 = TypedGradient<ColorRGBA8>;
+using GradientRGBAf = TypedGradient<ColorRGBAf>;
+using GradientRGBAd = TypedGradient<ColorRGBAd, double>;
+
+} // namespace ImGG
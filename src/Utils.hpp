@@ -1,6 +1,8 @@
 #pragma once
 #include <cmath>
+#include <cstddef>
 #include "RelativePosition.hpp"
+#include "WrapMode.hpp"
 
 // https://registry.khronos.org/OpenGL/specs/gl/glspec46.core.pdf page 260
 
@@ -35,4 +37,32 @@ inline auto mirror_repeat_position(float position) -> RelativePosition
     return RelativePosition{1.f - (std::abs(modulo(position, 2.f) - 1.f))};
 }
 
+/// The position at which `CompiledGradient::bake()` samples texel `texel_index` of a LUT of `size` texels.
+inline auto texel_center(size_t texel_index, size_t size) -> float
+{
+    return (static_cast<float>(texel_index) + 0.5f) / static_cast<float>(size);
+}
+
+/// Same as `RelativePosition{position, wrap_mode}`, but without a runtime switch on the wrap mode.
+template<WrapMode wrap_mode>
+auto wrap_position(float position) -> RelativePosition;
+
+template<>
+inline auto wrap_position<WrapMode::Clamp>(float position) -> RelativePosition
+{
+    return clamp_position(position);
+}
+
+template<>
+inline auto wrap_position<WrapMode::Repeat>(float position) -> RelativePosition
+{
+    return repeat_position(position);
+}
+
+template<>
+inline auto wrap_position<WrapMode::MirrorRepeat>(float position) -> RelativePosition
+{
+    return mirror_repeat_position(position);
+}
+
 }} // namespace ImGG::internal
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include "bake_size.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <initializer_list>
+#include <vector>
+
+namespace ImGG {
+
+static auto max_difference(const ColorRGBA& a, const ColorRGBA& b) -> float
+{
+    return std::max(std::max(std::abs(a.x - b.x), std::abs(a.y - b.y)),
+                    std::max(std::abs(a.z - b.z), std::abs(a.w - b.w)));
+}
+
+static auto texel_color(const CompiledGradient& gradient, size_t texel_index, size_t size) -> ColorRGBA
+{
+    return gradient.at(RelativePosition{internal::texel_center(texel_index, size)});
+}
+
+/// What the GPU returns when sampling the LUT at `position` with linear filtering.
+static auto linearly_filtered_color(const CompiledGradient& gradient, float position, size_t size) -> ColorRGBA
+{
+    const float texel = position * static_cast<float>(size) - 0.5f;
+    if (texel <= 0.f)
+        return texel_color(gradient, 0, size);
+    if (texel >= static_cast<float>(size - 1))
+        return texel_color(gradient, size - 1, size);
+
+    const auto      index = static_cast<size_t>(texel);
+    const float     t     = texel - static_cast<float>(index);
+    const ColorRGBA a     = texel_color(gradient, index, size);
+    const ColorRGBA b     = texel_color(gradient, index + 1, size);
+    return ColorRGBA{
+        a.x + (b.x - a.x) * t,
+        a.y + (b.y - a.y) * t,
+        a.z + (b.z - a.z) * t,
+        a.w + (b.w - a.w) * t,
+    };
+}
+
+/// The color of `segment` at `position`, converted back to sRGB.
+static auto segment_color(const internal::SamplingData& data, size_t segment, float position) -> ColorRGBA
+{
+    return internal::from_color_space(internal::InterpolationPolicy<Interpolation::Cubic>::segment_color(data.segments[segment], position), data.color_space);
+}
+
+/// Both the gradient and the filtered LUT are linear between the marks and the texel centers, so their difference is too,
+/// and it is biggest on one of the marks, on one of the texel centers (where it is 0), or at the ends of the [0, 1] range.
+/// When the gradient is curved between the marks (`Interpolation::Cubic`, colors that are not interpolated in sRGB, or segments with a midpoint),
+/// the difference can be biggest anywhere, so we also sample a few points inside of each of the pieces delimited by the marks and the texel centers.
+/// This is only an estimate in that case: a curve that bends sharply between the samples can be further from the LUT.
+static auto filtered_bake_error(const CompiledGradient& gradient, size_t size) -> float
+{
+    static constexpr int samples_per_piece = 8;
+
+    const auto data          = gradient.sampling_data();
+    const bool has_midpoints = std::any_of(data.segments, data.segments + data.positions_count + 1, [](const internal::Segment& segment) {
+        return segment.bias.slope != 0.f;
+    });
+
+    float error = 0.f;
+    for (const float position : {0.f, 1.f})
+    {
+        error = std::max(error, max_difference(linearly_filtered_color(gradient, position, size),
+                                               segment_color(data, internal::segment_index(data, position), position)));
+    }
+    for (size_t i = 0; i < data.positions_count; ++i)
+    {
+        // Compare with the colors on both sides of the mark, because the color exactly on the mark can be different (see `Gradient::at()`).
+        const float     position = data.positions[i];
+        const ColorRGBA filtered = linearly_filtered_color(gradient, position, size);
+        error                    = std::max(error, max_difference(filtered, segment_color(data, i, position)));
+        error                    = std::max(error, max_difference(filtered, segment_color(data, i + 1, position)));
+    }
+    if (gradient.interpolation_mode() == Interpolation::Cubic || data.color_space != ColorSpace::sRGB || has_midpoints)
+    {
+        // The pieces on which both the gradient and the filtered LUT are smooth
+        std::vector<float> knots{0.f, 1.f};
+        knots.insert(knots.end(), data.positions, data.positions + data.positions_count);
+        for (size_t texel = 0; texel < size; ++texel)
+            knots.push_back(internal::texel_center(texel, size));
+        std::sort(knots.begin(), knots.end());
+        for (size_t i = 0; i + 1 < knots.size(); ++i)
+        {
+            for (int sample = 1; sample < samples_per_piece; ++sample)
+            {
+                const float position = knots[i] + (knots[i + 1] - knots[i]) * static_cast<float>(sample) / static_cast<float>(samples_per_piece);
+                if (position <= knots[i] || position >= knots[i + 1]) // The piece is too small to have any float inside of it
+                    continue;
+                error = std::max(error, max_difference(linearly_filtered_color(gradient, position, size),
+                                                       segment_color(data, internal::segment_index(data, position), position)));
+            }
+        }
+    }
+    return error;
+}
+
+static auto constant_bake_error(const CompiledGradient& gradient, size_t size) -> float
+{
+    const auto  data   = gradient.sampling_data();
+    const float size_f = static_cast<float>(size);
+    float       error  = 0.f;
+    for (size_t i = 0; i <= data.positions_count; ++i)
+    {
+        const float begin = i == 0 ? 0.f : data.positions[i - 1];
+        const float end   = i == data.positions_count ? 1.f : data.positions[i];
+        if (begin >= end)
+            continue;
+
+        // Look for a texel center strictly inside the band
+        auto texel = static_cast<size_t>(std::max(std::floor(begin * size_f - 0.5f), 0.f));
+        while (texel < size && internal::texel_center(texel, size) <= begin)
+            ++texel;
+        if (texel < size && internal::texel_center(texel, size) < end)
+            continue;
+
+        // The band is missing from the LUT, and its middle gets the color of whichever texel covers it
+        const auto middle_texel = std::min(static_cast<size_t>((begin + end) * 0.5f * size_f), size - 1);
+        error                   = std::max(error, max_difference(internal::from_color_space(data.segments[i].color, data.color_space), texel_color(gradient, middle_texel, size)));
+    }
+    return error;
+}
+
+auto estimated_bake_error(const CompiledGradient& gradient, size_t size) -> float
+{
+    assert(size > 0 && "A LUT must have at least one texel");
+    switch (gradient.interpolation_mode())
+    {
+    case Interpolation::Linear:
+    case Interpolation::Cubic:
+        return filtered_bake_error(gradient, size);
+    case Interpolation::Constant:
+        return constant_bake_error(gradient, size);
+    default:
+        assert(false && "[ImGuiGradient::estimated_bake_error] Invalid enum value");
+        return 0.f;
+    }
+}
+
+auto choose_bake_size(const CompiledGradient& gradient, float tolerance, size_t max_size) -> BakeSize
+{
+    assert(max_size > 0 && "A LUT must have at least one texel");
+    const float first_error = estimated_bake_error(gradient, 1);
+    if (first_error <= tolerance)
+        return BakeSize{1, first_error};
+
+    // Double the size until it meets the tolerance, so that it is between `failing_size` and `passing_size`.
+    size_t failing_size = 1;
+    size_t passing_size = 1;
+    float  passing_error;
+    while (true)
+    {
+        passing_size  = std::min(failing_size * 2, max_size);
+        passing_error = estimated_bake_error(gradient, passing_size);
+        if (passing_error <= tolerance)
+            break;
+        if (passing_size == max_size)
+            return BakeSize{max_size, passing_error};
+        failing_size = passing_size;
+    }
+
+    // Then bisect until they are next to each other. The error doesn't always decrease when the size increases (the texel centers can fall
+    // closer to or further from the marks), so this might miss an even smaller size that meets the tolerance.
+    while (passing_size - failing_size > 1)
+    {
+        const size_t size  = failing_size + (passing_size - failing_size) / 2;
+        const float  error = estimated_bake_error(gradient, size);
+        if (error <= tolerance)
+        {
+            passing_size  = size;
+            passing_error = error;
+        }
+        else
+        {
+            failing_size = size;
+        }
+    }
+    return BakeSize{passing_size, passing_error};
+}
+
+} // namespace ImGG
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include "CompiledGradient.hpp"
+
+namespace ImGG {
+
+/// A LUT size, and the estimated error of the LUT of that size.
+struct BakeSize {
+    size_t size;
+    /// `estimated_bake_error()` of the LUT: the biggest difference between the LUT and the gradient, on any of the R, G, B and A channels (which go from 0 to 1).
+    float estimated_error;
+};
+
+/// The biggest difference between `gradient` and the LUT of `size` texels produced by `CompiledGradient::bake()`, on any of the channels.
+/// With `Interpolation::Linear` and `Interpolation::Cubic`, the LUT is assumed to be sampled with linear filtering and clamping, like a 1D texture with GL_LINEAR and GL_CLAMP_TO_EDGE.
+/// With `Interpolation::Constant`, it is assumed to be sampled with nearest filtering: the edges between the colors move by less than half a texel,
+/// and the error comes from the bands of color that are too thin to contain the center of a texel, and so are missing from the LUT.
+/// The result is exact when the gradient is made of straight lines (`Interpolation::Linear` in `ColorSpace::sRGB` without any `Mark::midpoint`, or `Interpolation::Constant`).
+/// If the gradient is curved between the marks (`Interpolation::Cubic`, not interpolated in `ColorSpace::sRGB`, or with a `Mark::midpoint` other than 0.5),
+/// it is only an estimate: the error is sampled at a few points between each pair of texels, which costs O(size), and can be lower than the actual error where the curve bends sharply.
+/// Leave some margin in the tolerance for such gradients.
+auto estimated_bake_error(const CompiledGradient& gradient, size_t size) -> float;
+
+/// Returns a LUT size whose `estimated_bake_error()` is at most `tolerance`, while the one of the size just below is not.
+/// The error usually decreases when the size increases, so this is the smallest size that meets the tolerance. But not always
+/// (the texel centers can fall closer to or further from the marks), in which case an even smaller size might also meet it.
+/// If even a LUT of `max_size` texels doesn't meet it, returns `max_size` and the error of that size.
+/// It is found with a doubling search followed by a bisection, so it only measures the error of O(log(max_size)) sizes.
+auto choose_bake_size(const CompiledGradient& gradient, float tolerance, size_t max_size = 4096) -> BakeSize;
+
+} // namespace ImGG
@@ -0,0 +1,82 @@
+#include "color_conversions.hpp"
+#include <cmath>
+
+namespace ImGG { namespace internal {
+
+// https://en.wikipedia.org/wiki/SRGB#Transformation
+
+static auto srgb_to_linear(float channel) -> float
+{
+    const float magnitude = std::abs(channel);
+    const float linear    = magnitude <= 0.04045f
+                                ? magnitude / 12.92f
+                                : std::pow((magnitude + 0.055f) / 1.055f, 2.4f);
+    return std::copysign(linear, channel);
+}
+
+static auto linear_to_srgb(float channel) -> float
+{
+    const float magnitude = std::abs(channel);
+    const float srgb      = magnitude <= 0.0031308f
+                                ? magnitude * 12.92f
+                                : 1.055f * std::pow(magnitude, 1.f / 2.4f) - 0.055f;
+    return std::copysign(srgb, channel);
+}
+
+auto srgb_to_linear_rgb(const ColorRGBA& color) -> ColorRGBA
+{
+    return ColorRGBA{srgb_to_linear(color.x), srgb_to_linear(color.y), srgb_to_linear(color.z), color.w};
+}
+
+auto linear_rgb_to_srgb(const ColorRGBA& color) -> ColorRGBA
+{
+    return ColorRGBA{linear_to_srgb(color.x), linear_to_srgb(color.y), linear_to_srgb(color.z), color.w};
+}
+
+// https://bottosson.github.io/posts/oklab/#converting-from-linear-srgb-to-oklab
+
+auto srgb_to_oklab(const ColorRGBA& color) -> ColorRGBA
+{
+    const ColorRGBA linear = srgb_to_linear_rgb(color);
+
+    const float l = std::cbrt(0.4122214708f * linear.x + 0.5363325363f * linear.y + 0.0514459929f * linear.z);
+    const float m = std::cbrt(0.2119034982f * linear.x + 0.6806995451f * linear.y + 0.1073969566f * linear.z);
+    const float s = std::cbrt(0.0883024619f * linear.x + 0.2817188376f * linear.y + 0.6299787005f * linear.z);
+
+    return ColorRGBA{
+        0.2104542553f * l + 0.7936177850f * m - 0.0040720468f * s,
+        1.9779984951f * l - 2.4285922050f * m + 0.4505937099f * s,
+        0.0259040371f * l + 0.7827717662f * m - 0.8086757660f * s,
+        color.w,
+    };
+}
+
+auto oklab_to_srgb(const ColorRGBA& color) -> ColorRGBA
+{
+    const float l_cbrt = color.x + 0.3963377774f * color.y + 0.2158037573f * color.z;
+    const float m_cbrt = color.x - 0.1055613458f * color.y - 0.0638541728f * color.z;
+    const float s_cbrt = color.x - 0.0894841775f * color.y - 1.2914855480f * color.z;
+
+    const float l = l_cbrt * l_cbrt * l_cbrt;
+    const float m = m_cbrt * m_cbrt * m_cbrt;
+    const float s = s_cbrt * s_cbrt * s_cbrt;
+
+    return linear_rgb_to_srgb(ColorRGBA{
+        +4.0767416621f * l - 3.3077115913f * m + 0.2309699292f * s,
+        -1.2684380046f * l + 2.6097574011f * m - 0.3413193965f * s,
+        -0.0041960863f * l - 0.7034186147f * m + 1.7076147010f * s,
+        color.w,
+    });
+}
+
+void from_color_space(ColorRGBA* colors, const size_t count, const ColorSpace color_space)
+{
+    if (color_space == ColorSpace::sRGB)
+        return;
+    for (size_t i = 0; i < count; ++i)
+    {
+        colors[i] = from_color_space(colors[i], color_space);
+    }
+}
+
+}} // namespace ImGG::internal
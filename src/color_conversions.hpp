@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include "ColorRGBA.hpp"
+#include "ColorSpace.hpp"
+
+namespace ImGG { namespace internal {
+
+/// The alpha channel is never converted: it is interpolated as is in all the color spaces.
+/// The components outside of the [0, 1] range (e.g. HDR colors) are converted too, the transfer functions are extended symmetrically around 0.
+auto srgb_to_linear_rgb(const ColorRGBA& color) -> ColorRGBA;
+auto linear_rgb_to_srgb(const ColorRGBA& color) -> ColorRGBA;
+auto srgb_to_oklab(const ColorRGBA& color) -> ColorRGBA;
+auto oklab_to_srgb(const ColorRGBA& color) -> ColorRGBA;
+
+/// Converts an sRGB `color` to `color_space`.
+inline auto to_color_space(const ColorRGBA& color, ColorSpace color_space) -> ColorRGBA
+{
+    switch (color_space)
+    {
+    case ColorSpace::sRGB:
+        return color;
+    case ColorSpace::LinearRGB:
+        return srgb_to_linear_rgb(color);
+    case ColorSpace::OKLab:
+        return srgb_to_oklab(color);
+    default:
+        assert(false && "[ImGuiGradient::to_color_space] Invalid enum value");
+        return color;
+    }
+}
+
+/// Converts a `color` that is in `color_space` back to sRGB.
+inline auto from_color_space(const ColorRGBA& color, ColorSpace color_space) -> ColorRGBA
+{
+    switch (color_space)
+    {
+    case ColorSpace::sRGB:
+        return color;
+    case ColorSpace::LinearRGB:
+        return linear_rgb_to_srgb(color);
+    case ColorSpace::OKLab:
+        return oklab_to_srgb(color);
+    default:
+        assert(false && "[ImGuiGradient::from_color_space] Invalid enum value");
+        return color;
+    }
+}
+
+/// Converts `count` colors from `color_space` back to sRGB, in place.
+void from_color_space(ColorRGBA* colors, size_t count, ColorSpace color_space);
+
+}} // namespace ImGG::internal
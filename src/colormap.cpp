@@ -0,0 +1,132 @@
+#include "colormap.hpp"
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace ImGG {
+
+// Big enough that the cost of dispatching a tile is negligible, small enough that there are many more tiles than threads on big images,
+// so that the threads that finish early can steal some work from the other ones.
+static constexpr size_t tile_width  = 1024;
+static constexpr size_t tile_height = 16;
+
+/// Calls `colormap_row(x, y, count)` on all the rows of all the tiles of the image.
+template<typename ColormapRow>
+static void for_each_tile_row(size_t width, size_t height, ThreadPool& thread_pool, ColormapRow&& colormap_row)
+{
+    const size_t tiles_per_row    = (width + tile_width - 1) / tile_width;
+    const size_t tiles_per_column = (height + tile_height - 1) / tile_height;
+    thread_pool.parallel_for(tiles_per_row * tiles_per_column, [&](size_t tile_index) {
+        const size_t x       = (tile_index % tiles_per_row) * tile_width;
+        const size_t y_begin = (tile_index / tiles_per_row) * tile_height;
+        const size_t y_end   = std::min(y_begin + tile_height, height);
+        const size_t count   = std::min(tile_width, width - x);
+        for (size_t y = y_begin; y < y_end; ++y)
+        {
+            colormap_row(x, y, count);
+        }
+    });
+}
+
+void colormap(
+    const CompiledGradient& gradient,
+    const float* image, size_t width, size_t height, size_t row_stride,
+    WrapMode    wrap_mode,
+    ColorRGBA*  output,
+    ThreadPool& thread_pool
+)
+{
+    assert(row_stride >= width && "The rows of the image overlap");
+    for_each_tile_row(width, height, thread_pool, [&](size_t x, size_t y, size_t count) {
+        gradient.sample(image + y * row_stride + x, output + y * width + x, count, wrap_mode);
+    });
+}
+
+void colormap_rgba8(
+    const CompiledGradient& gradient,
+    const float* image, size_t width, size_t height, size_t row_stride,
+    WrapMode    wrap_mode,
+    ImU32*      output,
+    ThreadPool& thread_pool
+)
+{
+    assert(row_stride >= width && "The rows of the image overlap");
+    for_each_tile_row(width, height, thread_pool, [&](size_t x, size_t y, size_t count) {
+        ColorRGBA colors[tile_width];
+        gradient.sample(image + y * row_stride + x, colors, count, wrap_mode);
+        for (size_t i = 0; i < count; ++i)
+        {
+            output[y * width + x + i] = internal::pack_rgba8(colors[i]);
+        }
+    });
+}
+
+void colormap_indices(
+    const StepGradient& step_gradient,
+    const float* image, size_t width, size_t height, size_t row_stride,
+    WrapMode    wrap_mode,
+    uint32_t*   output,
+    ThreadPool& thread_pool
+)
+{
+    assert(row_stride >= width && "The rows of the image overlap");
+    for_each_tile_row(width, height, thread_pool, [&](size_t x, size_t y, size_t count) {
+        step_gradient.sample_indices(image + y * row_stride + x, output + y * width + x, count, wrap_mode);
+    });
+}
+
+void colormap_rgba8(
+    const StepGradient& step_gradient,
+    const float* image, size_t width, size_t height, size_t row_stride,
+    WrapMode    wrap_mode,
+    ImU32*      output,
+    ThreadPool& thread_pool
+)
+{
+    assert(row_stride >= width && "The rows of the image overlap");
+    for_each_tile_row(width, height, thread_pool, [&](size_t x, size_t y, size_t count) {
+        step_gradient.sample_rgba8(image + y * row_stride + x, output + y * width + x, count, wrap_mode);
+    });
+}
+
+template<typename Integer>
+static void colormap_integers_rgba8(
+    const IntegerColormap<Integer>& integer_colormap,
+    const Integer* image, size_t width, size_t height, size_t row_stride,
+    ImU32*      output,
+    ThreadPool& thread_pool
+)
+{
+    assert(row_stride >= width && "The rows of the image overlap");
+    const ImU32* const table = integer_colormap.table();
+    for_each_tile_row(width, height, thread_pool, [&](size_t x, size_t y, size_t count) {
+        const Integer* const values = image + y * row_stride + x;
+        ImU32* const         colors = output + y * width + x;
+        for (size_t i = 0; i < count; ++i)
+        {
+            colors[i] = table[values[i]];
+        }
+    });
+}
+
+void colormap_rgba8(
+    const IntegerColormap8& integer_colormap,
+    const uint8_t* image, size_t width, size_t height, size_t row_stride,
+    ImU32*      output,
+    ThreadPool& thread_pool
+)
+{
+    colormap_integers_rgba8(integer_colormap, image, width, height, row_stride, output, thread_pool);
+}
+
+void colormap_rgba8(
+    const IntegerColormap16& integer_colormap,
+    const uint16_t* image, size_t width, size_t height, size_t row_stride,
+    ImU32*      output,
+    ThreadPool& thread_pool
+)
+{
+    colormap_integers_rgba8(integer_colormap, image, width, height, row_stride, output, thread_pool);
+}
+
+} // namespace ImGG
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include "ColorRGBA.hpp"
+#include "CompiledGradient.hpp"
+#include "IntegerColormap.hpp"
+#include "StepGradient.hpp"
+#include "ThreadPool.hpp"
+#include "WrapMode.hpp"
+
+namespace ImGG {
+
+/// Replaces each value of a grayscale `image` with the color of the gradient at that position.
+/// `image` has `height` rows of `width` values, and each row starts `row_stride` values after the previous one (`row_stride >= width`).
+/// `output` must have room for `width * height` colors, and is tightly packed (its row stride is `width`).
+/// The image is split into tiles that are colormapped in parallel by the threads of `thread_pool`.
+/// Each pixel is computed independently of the others, so the result doesn't depend on the number of threads.
+void colormap(
+    const CompiledGradient& gradient,
+    const float* image, size_t width, size_t height, size_t row_stride,
+    WrapMode    wrap_mode,
+    ColorRGBA*  output,
+    ThreadPool& thread_pool = default_thread_pool()
+);
+
+/// Same as `colormap()`, but packs the colors as 8-bit RGBA, like `ImGui::ColorConvertFloat4ToU32()` does.
+void colormap_rgba8(
+    const CompiledGradient& gradient,
+    const float* image, size_t width, size_t height, size_t row_stride,
+    WrapMode    wrap_mode,
+    ImU32*      output,
+    ThreadPool& thread_pool = default_thread_pool()
+);
+
+/// Labels each value of a grayscale `image` with the index in `step_gradient.palette()` of the color at that position, e.g. to classify the pixels.
+/// `image`, `width`, `height`, `row_stride`, `wrap_mode` and `thread_pool` work the same way as in `colormap()`, and `output` must have room for `width * height` indices.
+void colormap_indices(
+    const StepGradient& step_gradient,
+    const float* image, size_t width, size_t height, size_t row_stride,
+    WrapMode    wrap_mode,
+    uint32_t*   output,
+    ThreadPool& thread_pool = default_thread_pool()
+);
+
+/// Same as `colormap_rgba8()`, but with the palette of a `StepGradient`.
+void colormap_rgba8(
+    const StepGradient& step_gradient,
+    const float* image, size_t width, size_t height, size_t row_stride,
+    WrapMode    wrap_mode,
+    ImU32*      output,
+    ThreadPool& thread_pool = default_thread_pool()
+);
+
+/// Colormaps 8-bit or 16-bit integer data through the table of `integer_colormap`, i.e. with a single lookup per pixel.
+/// `image`, `width`, `height`, `row_stride`, `output` and `thread_pool` work the same way as in `colormap()`.
+void colormap_rgba8(
+    const IntegerColormap8& integer_colormap,
+    const uint8_t* image, size_t width, size_t height, size_t row_stride,
+    ImU32*      output,
+    ThreadPool& thread_pool = default_thread_pool()
+);
+void colormap_rgba8(
+    const IntegerColormap16& integer_colormap,
+    const uint16_t* image, size_t width, size_t height, size_t row_stride,
+    ImU32*      output,
+    ThreadPool& thread_pool = default_thread_pool()
+);
+
+} // namespace ImGG
@@ -0,0 +1,134 @@
+#include "cpu_features.hpp"
+#include <initializer_list>
+
+#if IMGG_ARCH_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace ImGG { namespace internal {
+
+#if IMGG_ARCH_X86
+struct CpuidRegisters {
+    unsigned int eax{0};
+    unsigned int ebx{0};
+    unsigned int ecx{0};
+    unsigned int edx{0};
+};
+
+static auto cpuid(unsigned int leaf, unsigned int subleaf) -> CpuidRegisters
+{
+    auto registers = CpuidRegisters{};
+#if defined(_MSC_VER) && !defined(__clang__)
+    int values[4];
+    __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+    registers.eax = static_cast<unsigned int>(values[0]);
+    registers.ebx = static_cast<unsigned int>(values[1]);
+    registers.ecx = static_cast<unsigned int>(values[2]);
+    registers.edx = static_cast<unsigned int>(values[3]);
+#else
+    __cpuid_count(leaf, subleaf, registers.eax, registers.ebx, registers.ecx, registers.edx);
+#endif
+    return registers;
+}
+
+static auto has_bit(unsigned int value, unsigned int bit) -> bool
+{
+    return (value & (1u << bit)) != 0;
+}
+
+/// The CPU supporting AVX is not enough, the OS also needs to save the YMM registers when switching threads.
+static auto os_saves_avx_registers() -> bool
+{
+    if (!has_bit(cpuid(1, 0).ecx, 27)) // OSXSAVE
+        return false;
+#if defined(_MSC_VER) && !defined(__clang__)
+    const auto xcr0 = static_cast<unsigned int>(_xgetbv(0));
+#else
+    unsigned int xcr0{0};
+    unsigned int xcr0_high{0};
+    __asm__("xgetbv"
+            : "=a"(xcr0), "=d"(xcr0_high)
+            : "c"(0));
+    (void)xcr0_high;
+#endif
+    return (xcr0 & 0x6u) == 0x6u; // Both the XMM and YMM states are enabled
+}
+
+static auto cpu_supports_avx2() -> bool
+{
+    return cpuid(0, 0).eax >= 7
+           && has_bit(cpuid(1, 0).ecx, 28) // AVX
+           && has_bit(cpuid(7, 0).ebx, 5)  // AVX2
+           && os_saves_avx_registers();
+}
+
+static auto cpu_supports_f16c() -> bool
+{
+    return has_bit(cpuid(1, 0).ecx, 28)    // AVX, because F16C uses the VEX encoding
+           && has_bit(cpuid(1, 0).ecx, 29) // F16C
+           && os_saves_avx_registers();
+}
+
+static auto cpu_supports_sse2() -> bool
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    return true; // Part of the x86-64 baseline
+#else
+    return has_bit(cpuid(1, 0).edx, 26);
+#endif
+}
+#endif
+
+auto is_supported(InstructionSet instruction_set) -> bool
+{
+    switch (instruction_set)
+    {
+    case InstructionSet::Scalar:
+        return true;
+#if IMGG_ARCH_X86
+    case InstructionSet::SSE2:
+    {
+        static const bool supported = cpu_supports_sse2();
+        return supported;
+    }
+    case InstructionSet::AVX2:
+    {
+        static const bool supported = cpu_supports_avx2();
+        return supported;
+    }
+    case InstructionSet::F16C:
+    {
+        static const bool supported = cpu_supports_f16c();
+        return supported;
+    }
+#endif
+#if IMGG_ARCH_ARM64
+    case InstructionSet::NEON:
+        return true; // Part of the AArch64 baseline
+#endif
+    default:
+        return false;
+    }
+}
+
+static auto detect_best_instruction_set() -> InstructionSet
+{
+    for (const InstructionSet instruction_set : {InstructionSet::AVX2, InstructionSet::SSE2, InstructionSet::NEON})
+    {
+        if (is_supported(instruction_set))
+            return instruction_set;
+    }
+    return InstructionSet::Scalar;
+}
+
+auto best_instruction_set() -> InstructionSet
+{
+    static const InstructionSet best = detect_best_instruction_set();
+    return best;
+}
+
+}} // namespace ImGG::internal
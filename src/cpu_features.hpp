@@ -0,0 +1,36 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define IMGG_ARCH_X86 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define IMGG_ARCH_ARM64 1
+#endif
+
+/// Allows a function to use the instructions of `instruction_set` even if the rest of the library is not compiled for it.
+/// MSVC doesn't need it, it lets you use any intrinsic anywhere.
+#if defined(__GNUC__) || defined(__clang__)
+#define IMGG_TARGET(instruction_set) __attribute__((target(instruction_set)))
+#else
+#define IMGG_TARGET(instruction_set)
+#endif
+
+namespace ImGG { namespace internal {
+
+/// The instruction sets that we have hand-written code paths for.
+enum class InstructionSet {
+    Scalar,
+    SSE2,
+    AVX2,
+    NEON,
+    /// Conversions between floats and half floats. It is not used by the sampling kernels, only by the half float bakes.
+    F16C,
+};
+
+/// Returns true iff the CPU we are running on supports `instruction_set`, and this build contains a code path for it.
+auto is_supported(InstructionSet instruction_set) -> bool;
+
+/// Returns the fastest of the supported instruction sets.
+/// The CPU is only queried the first time this is called.
+auto best_instruction_set() -> InstructionSet;
+
+}} // namespace ImGG::internal
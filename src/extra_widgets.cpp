@@ -90,13 +90,15 @@ auto wrap_mode_widget(const char* label, WrapMode* wrap_mode, const bool should_
 
 auto interpolation_mode_widget(const char* label, Interpolation* interpolation_mode, const bool should_show_tooltip) -> bool
 {
-    static constexpr std::array<const char*, 2> items = {
+    static constexpr std::array<const char*, 3> items = {
         "Linear",
         "Constant",
+        "Cubic",
     };
-    static constexpr std::array<const char*, 2> tooltips = {
+    static constexpr std::array<const char*, 3> tooltips = {
         "Linear interpolation between two marks",
         "Constant color between two marks",
+        "Smooth curve through all the marks",
     };
 
     return selector_with_tooltip(
@@ -108,4 +110,27 @@ auto interpolation_mode_widget(const char* label, Interpolation* interpolation_m
         should_show_tooltip
     );
 }
+
+auto color_space_widget(const char* label, ColorSpace* color_space, const bool should_show_tooltip) -> bool
+{
+    static constexpr std::array<const char*, 3> items = {
+        "sRGB",
+        "Linear RGB",
+        "OKLab",
+    };
+    static constexpr std::array<const char*, 3> tooltips = {
+        "Interpolates the sRGB components directly",
+        "Interpolates the amount of light, which avoids the dark bands between saturated colors",
+        "Interpolates in a perceptual color space, so that the lightness and the hue change evenly",
+    };
+
+    return selector_with_tooltip(
+        label,
+        reinterpret_cast<size_t*>(color_space),
+        items,
+        "Linear RGB",
+        tooltips,
+        should_show_tooltip
+    );
+}
 } // namespace ImGG
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "ColorSpace.hpp"
 #include "Interpolation.hpp"
 #include "WrapMode.hpp"
 
@@ -23,4 +24,10 @@ auto interpolation_mode_widget(
     bool           should_show_tooltip = true
 ) -> bool;
 
+auto color_space_widget(
+    const char* label,
+    ColorSpace* color_space,
+    bool        should_show_tooltip = true
+) -> bool;
+
 } // namespace ImGG
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "half_float.hpp"
+#include <cstring>
+
+#if IMGG_ARCH_X86
+#include <immintrin.h>
+#endif
+#if IMGG_ARCH_ARM64
+#include <arm_neon.h>
+#endif
+
+namespace ImGG { namespace internal {
+
+/// Shifts `value` right by `shift` bits, rounding to the nearest even integer.
+static auto shift_right_rounded(uint32_t value, uint32_t shift) -> uint32_t
+{
+    const uint32_t result    = value >> shift;
+    const uint32_t remainder = value & ((1u << shift) - 1u);
+    const uint32_t half      = 1u << (shift - 1u);
+    return remainder > half || (remainder == half && (result & 1u)) ? result + 1u : result;
+}
+
+auto float_to_half(float value) -> uint16_t
+{
+    uint32_t bits{};
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint32_t sign      = (bits >> 16) & 0x8000u;
+    const uint32_t magnitude = bits & 0x7FFFFFFFu;
+
+    if (magnitude >= 0x7F800000u) // Infinity or NaN
+        return static_cast<uint16_t>(sign | 0x7C00u | (magnitude > 0x7F800000u ? 0x0200u | ((magnitude >> 13) & 0x3FFu) : 0u));
+    if (magnitude >= 0x477FF000u) // 65520 and above round to infinity
+        return static_cast<uint16_t>(sign | 0x7C00u);
+    if (magnitude < 0x38800000u) // Below the smallest normal half float (2^-14): the result is subnormal, or zero
+    {
+        if (magnitude < 0x33000000u) // Below 2^-25: rounds to zero
+            return static_cast<uint16_t>(sign);
+        const uint32_t exponent = magnitude >> 23;
+        const uint32_t mantissa = (magnitude & 0x7FFFFFu) | 0x800000u;
+        return static_cast<uint16_t>(sign | shift_right_rounded(mantissa, 126u - exponent)); // If it rounds up to 0x400 this is the smallest normal, which is correct
+    }
+    // Rebias the exponent from 127 to 15. If the mantissa rounds up, the carry correctly goes into the exponent.
+    return static_cast<uint16_t>(sign | shift_right_rounded(magnitude - 0x38000000u, 13u));
+}
+
+auto half_to_float(uint16_t half) -> float
+{
+    const uint32_t sign     = static_cast<uint32_t>(half & 0x8000u) << 16;
+    const uint32_t exponent = (half >> 10) & 0x1Fu;
+    const uint32_t mantissa = half & 0x3FFu;
+
+    uint32_t bits{};
+    if (exponent == 0)
+    {
+        const float magnitude = static_cast<float>(mantissa) / 16777216.f; // Subnormal: mantissa * 2^-24, which is exact
+        return sign ? -magnitude : magnitude;
+    }
+    else if (exponent == 0x1Fu)
+    {
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    }
+    else
+    {
+        bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+    }
+    float value{};
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void floats_to_halves_scalar(const float* floats, uint16_t* halves, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+        halves[i] = float_to_half(floats[i]);
+}
+
+#if IMGG_ARCH_X86
+IMGG_TARGET("avx,f16c")
+void floats_to_halves_f16c(const float* floats, uint16_t* halves, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128i result = _mm256_cvtps_ph(_mm256_loadu_ps(floats + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(halves + i), result);
+    }
+    _mm256_zeroupper(); // See sample_avx2_impl() in "sample_kernels.cpp"
+    floats_to_halves_scalar(floats + i, halves + i, count - i);
+}
+#endif
+
+#if IMGG_ARCH_ARM64
+void floats_to_halves_neon(const float* floats, uint16_t* halves, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1_u16(halves + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(floats + i)))); // Rounds to nearest even, the default rounding mode
+    }
+    floats_to_halves_scalar(floats + i, halves + i, count - i);
+}
+#endif
+
+void floats_to_halves(const float* floats, uint16_t* halves, size_t count)
+{
+#if IMGG_ARCH_ARM64
+    floats_to_halves_neon(floats, halves, count); // Part of the AArch64 baseline
+#else
+#if IMGG_ARCH_X86
+    if (is_supported(InstructionSet::F16C))
+    {
+        floats_to_halves_f16c(floats, halves, count);
+        return;
+    }
+#endif
+    floats_to_halves_scalar(floats, halves, count);
+#endif
+}
+
+}} // namespace ImGG::internal
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "cpu_features.hpp"
+
+namespace ImGG { namespace internal {
+
+/// Converts a float to an IEEE 754 half float, rounding to the nearest even value like the hardware does.
+/// Values that are too big become infinities, and NaNs stay NaNs.
+auto float_to_half(float value) -> uint16_t;
+auto half_to_float(uint16_t half) -> float;
+
+/// Converts `count` floats to half floats, with the fastest method that the CPU supports (F16C, NEON, or software).
+/// All the methods give exactly the same results.
+void floats_to_halves(const float* floats, uint16_t* halves, size_t count);
+
+void floats_to_halves_scalar(const float* floats, uint16_t* halves, size_t count);
+#if IMGG_ARCH_X86
+void floats_to_halves_f16c(const float* floats, uint16_t* halves, size_t count);
+#endif
+#if IMGG_ARCH_ARM64
+void floats_to_halves_neon(const float* floats, uint16_t* halves, size_t count);
+#endif
+
+}} // namespace ImGG::internal
@@ -1,5 +1,8 @@
+#include <algorithm>
 #include "Gradient.hpp"
 #include "Interpolation.hpp"
+#include "InterpolationPolicy.hpp"
+#include "color_conversions.hpp"
 #include "Settings.hpp"
 #include "internal.hpp"
 
@@ -36,6 +39,37 @@ static void draw_gradient_between_two_colors(
     );
 }
 
+/// ImGui interpolates the colors of the vertices linearly in sRGB, so to show a curved segment (`Interpolation::Cubic`, a `Mark::midpoint`, or an interpolation in another color space)
+/// we cut it into thin slices, whose edges have the exact colors.
+static void draw_curved_segment(
+    ImDrawList&                   draw_list,
+    const ImVec2                  top_left_corner,
+    const ImVec2                  bottom_rigth_corner,
+    const internal::SamplingData& data,
+    const internal::Segment&      segment,
+    const float position_left, const float position_right
+)
+{
+    static constexpr auto slice_width{4.f};
+
+    const auto color_at = [&](float t) {
+        const float position = ImLerp(position_left, position_right, t);
+        return ImGui::ColorConvertFloat4ToU32(internal::from_color_space(internal::InterpolationPolicy<Interpolation::Cubic>::segment_color(segment, position), data.color_space));
+    };
+    const int slices_count = std::max(static_cast<int>((bottom_rigth_corner.x - top_left_corner.x) / slice_width), 1);
+    for (int i = 0; i < slices_count; ++i)
+    {
+        const float t_left  = static_cast<float>(i) / static_cast<float>(slices_count);
+        const float t_right = static_cast<float>(i + 1) / static_cast<float>(slices_count);
+        draw_gradient_between_two_colors(
+            draw_list,
+            ImVec2{ImLerp(top_left_corner.x, bottom_rigth_corner.x, t_left), top_left_corner.y},
+            ImVec2{ImLerp(top_left_corner.x, bottom_rigth_corner.x, t_right), bottom_rigth_corner.y},
+            color_at(t_left), color_at(t_right)
+        );
+    }
+}
+
 void draw_gradient(
     ImDrawList&     draw_list,
     const Gradient& gradient,
@@ -44,6 +78,13 @@ void draw_gradient(
 )
 {
     assert(!gradient.is_empty());
+    const bool is_curved     = gradient.interpolation_mode() == Interpolation::Cubic
+                               || (gradient.interpolation_mode() == Interpolation::Linear && gradient.color_space() != ColorSpace::sRGB);
+    const auto has_midpoint  = [&](const Mark& mark) { return gradient.interpolation_mode() == Interpolation::Linear && mark.midpoint != 0.5f; };
+    const bool has_midpoints = std::any_of(gradient.get_marks().begin(), gradient.get_marks().end(), has_midpoint);
+    const auto compiled      = is_curved || has_midpoints ? gradient.compile() : CompiledGradient{}; // Has the coefficients of the curves
+    const auto data          = compiled.sampling_data();
+
     float current_starting_x = gradient_position.x;
     for (auto mark_iterator = gradient.get_marks().begin(); mark_iterator != gradient.get_marks().end(); ++mark_iterator) // We need to use iterators because we need to access the previous element from time to time
     {
@@ -55,7 +96,19 @@ void draw_gradient(
         const auto to{gradient_position.x + mark.position.get() * (size.x)};
         if (mark.position.get() != 0.f)
         {
-            if (gradient.interpolation_mode() == Interpolation::Linear)
+            if ((is_curved || has_midpoint(mark)) && mark_iterator != gradient.get_marks().begin())
+            {
+                draw_curved_segment(
+                    draw_list,
+                    ImVec2{from, gradient_position.y},
+                    ImVec2{to, gradient_position.y + size.y},
+                    data,
+                    data.segments[internal::segment_index(data, mark.position.get())], // The segment that ends on `mark`
+                    std::prev(mark_iterator)->position.get(), mark.position.get()
+                );
+            }
+            else if (gradient.interpolation_mode() == Interpolation::Linear
+                     || gradient.interpolation_mode() == Interpolation::Cubic)
             {
                 const ImU32 color_left = (mark_iterator != gradient.get_marks().begin())
                                              ? ImGui::ColorConvertFloat4ToU32(std::prev(mark_iterator)->color)
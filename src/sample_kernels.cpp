@@ -0,0 +1,693 @@
+#include "sample_kernels.hpp"
+#include <climits>
+#include "InterpolationPolicy.hpp"
+#include "Utils.hpp"
+
+#if IMGG_ARCH_X86
+#include <immintrin.h>
+#endif
+#if IMGG_ARCH_ARM64
+#include <arm_neon.h>
+#endif
+
+// All the kernels do exactly the same floating point operations as `internal::color_at()` and the wrap functions of "Utils.hpp",
+// so they return the same colors as the scalar code (as long as the compiler doesn't fuse the multiplications and additions differently).
+
+namespace ImGG { namespace internal {
+
+template<WrapMode wrap_mode>
+static void sample_scalar_impl(const SamplingData& data, const float* positions, ColorRGBA* colors, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float position = wrap_position<wrap_mode>(positions[i]).get();
+        colors[i]            = color_at(data, segment_index(data, position), position);
+    }
+}
+
+void sample_scalar(const SamplingData& data, const float* positions, ColorRGBA* colors, size_t count, WrapMode wrap_mode)
+{
+    switch (wrap_mode)
+    {
+    case WrapMode::Clamp:
+        return sample_scalar_impl<WrapMode::Clamp>(data, positions, colors, count);
+    case WrapMode::Repeat:
+        return sample_scalar_impl<WrapMode::Repeat>(data, positions, colors, count);
+    case WrapMode::MirrorRepeat:
+        return sample_scalar_impl<WrapMode::MirrorRepeat>(data, positions, colors, count);
+    default:
+        assert(false && "[ImGuiGradient::sample_scalar] Invalid enum value");
+    }
+}
+
+template<WrapMode wrap_mode>
+static void step_scalar_impl(const StepData& data, const float* positions, uint32_t* palette_indices, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float position = wrap_position<wrap_mode>(positions[i]).get();
+        palette_indices[i]   = step_palette_index(data, step_cell(data, position), position);
+    }
+}
+
+void step_scalar(const StepData& data, const float* positions, uint32_t* palette_indices, size_t count, WrapMode wrap_mode)
+{
+    switch (wrap_mode)
+    {
+    case WrapMode::Clamp:
+        return step_scalar_impl<WrapMode::Clamp>(data, positions, palette_indices, count);
+    case WrapMode::Repeat:
+        return step_scalar_impl<WrapMode::Repeat>(data, positions, palette_indices, count);
+    case WrapMode::MirrorRepeat:
+        return step_scalar_impl<WrapMode::MirrorRepeat>(data, positions, palette_indices, count);
+    default:
+        assert(false && "[ImGuiGradient::step_scalar] Invalid enum value");
+    }
+}
+
+template<WrapMode wrap_mode>
+static void multi_sample_scalar_impl(const PackedSamplingData& data, const uint32_t* gradient_indices, const float* positions, ColorRGBA* colors, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const SamplingData gradient = sampling_data_of(data, gradient_indices[i]);
+        const float        position = wrap_position<wrap_mode>(positions[i]).get();
+        colors[i]                   = from_color_space(color_at(gradient, segment_index(gradient, position), position), gradient.color_space);
+    }
+}
+
+void multi_sample_scalar(const PackedSamplingData& data, const uint32_t* gradient_indices, const float* positions, ColorRGBA* colors, size_t count, WrapMode wrap_mode)
+{
+    switch (wrap_mode)
+    {
+    case WrapMode::Clamp:
+        return multi_sample_scalar_impl<WrapMode::Clamp>(data, gradient_indices, positions, colors, count);
+    case WrapMode::Repeat:
+        return multi_sample_scalar_impl<WrapMode::Repeat>(data, gradient_indices, positions, colors, count);
+    case WrapMode::MirrorRepeat:
+        return multi_sample_scalar_impl<WrapMode::MirrorRepeat>(data, gradient_indices, positions, colors, count);
+    default:
+        assert(false && "[ImGuiGradient::multi_sample_scalar] Invalid enum value");
+    }
+}
+
+/// The vectorized binary search needs at least one mark, and the indices need to fit in 32-bit integers.
+static auto can_use_simd(const SamplingData& data) -> bool
+{
+    return data.positions_count > 0
+           && data.positions_count < INT_MAX / (sizeof(Segment) / sizeof(float));
+}
+
+/// The indices in the palette need to fit in 32-bit integers.
+static auto can_use_simd(const StepData& data) -> bool
+{
+    return data.positions_count < INT_MAX / 2;
+}
+
+#if IMGG_ARCH_X86
+
+/// Same as `InterpolationPolicy<Interpolation::Cubic>::segment_color()`.
+IMGG_TARGET("sse2")
+static auto segment_color_sse2(const Segment& segment, float t) -> __m128
+{
+    const __m128 t4        = _mm_set1_ps(t);
+    const __m128 quadratic = _mm_add_ps(_mm_loadu_ps(reinterpret_cast<const float*>(&segment.quadratic)), _mm_mul_ps(t4, _mm_loadu_ps(reinterpret_cast<const float*>(&segment.cubic))));
+    const __m128 slope     = _mm_add_ps(_mm_loadu_ps(reinterpret_cast<const float*>(&segment.slope)), _mm_mul_ps(t4, quadratic));
+    return _mm_add_ps(_mm_loadu_ps(reinterpret_cast<const float*>(&segment.color)), _mm_mul_ps(t4, slope));
+}
+
+IMGG_TARGET("sse2")
+static void write_color_sse2(const SamplingData& data, size_t index, float position, ColorRGBA& color)
+{
+    if (index < data.positions_count && data.positions[index] == position)
+    {
+        color = data.colors_on_marks[index];
+        return;
+    }
+    const Segment& segment = data.segments[index];
+    _mm_storeu_ps(reinterpret_cast<float*>(&color), segment_color_sse2(segment, segment_t(segment, position)));
+}
+
+IMGG_TARGET("sse2")
+static auto abs_sse2(__m128 x) -> __m128
+{
+    return _mm_andnot_ps(_mm_set1_ps(-0.f), x);
+}
+
+/// SSE2 doesn't have a floor instruction, so we go through a conversion to integer.
+IMGG_TARGET("sse2")
+static auto floor_sse2(__m128 x) -> __m128
+{
+    const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+    const __m128 floored   = _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, x), _mm_set1_ps(1.f)));
+    const __m128 is_big    = _mm_cmpge_ps(abs_sse2(x), _mm_set1_ps(8388608.f)); // Floats that big are already integers, and might not fit in an int
+    return _mm_or_ps(_mm_and_ps(is_big, x), _mm_andnot_ps(is_big, floored));
+}
+
+IMGG_TARGET("sse2")
+static auto fract_sse2(__m128 x) -> __m128
+{
+    return _mm_sub_ps(x, floor_sse2(x));
+}
+
+template<WrapMode wrap_mode>
+IMGG_TARGET("sse2")
+static auto wrap_sse2(__m128 position) -> __m128
+{
+    switch (wrap_mode)
+    {
+    case WrapMode::Clamp:
+        return _mm_min_ps(_mm_max_ps(position, _mm_setzero_ps()), _mm_set1_ps(1.f));
+    case WrapMode::Repeat:
+        return fract_sse2(position);
+    case WrapMode::MirrorRepeat:
+    {
+        const __m128 modulo = _mm_mul_ps(fract_sse2(_mm_mul_ps(position, _mm_set1_ps(0.5f))), _mm_set1_ps(2.f));
+        return _mm_sub_ps(_mm_set1_ps(1.f), abs_sse2(_mm_sub_ps(modulo, _mm_set1_ps(1.f))));
+    }
+    default:
+        return position;
+    }
+}
+
+template<WrapMode wrap_mode>
+IMGG_TARGET("sse2")
+static void sample_sse2_impl(const SamplingData& data, const float* positions, ColorRGBA* colors, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 position = wrap_sse2<wrap_mode>(_mm_loadu_ps(positions + i));
+
+        // Branchless binary search: all the lanes do the same number of steps.
+        __m128i base = _mm_setzero_si128();
+        size_t  len  = data.positions_count;
+        while (len > 1)
+        {
+            const size_t  half = len / 2;
+            const __m128i step = _mm_set1_epi32(static_cast<int>(half));
+            alignas(16) int probe_indices[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(probe_indices), _mm_add_epi32(base, step));
+            const __m128 probe = _mm_set_ps( // SSE2 has no gather instruction
+                data.positions[probe_indices[3]],
+                data.positions[probe_indices[2]],
+                data.positions[probe_indices[1]],
+                data.positions[probe_indices[0]]
+            );
+            base = _mm_add_epi32(base, _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(probe, position)), step));
+            len -= half;
+        }
+
+        alignas(16) int   bases[4];
+        alignas(16) float wrapped_positions[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(bases), base);
+        _mm_store_ps(wrapped_positions, position);
+        for (size_t lane = 0; lane < 4; ++lane)
+        {
+            const auto index = static_cast<size_t>(bases[lane]) + (data.positions[bases[lane]] < wrapped_positions[lane] ? 1 : 0);
+            write_color_sse2(data, index, wrapped_positions[lane], colors[i + lane]);
+        }
+    }
+    sample_scalar_impl<wrap_mode>(data, positions + i, colors + i, count - i);
+}
+
+void sample_sse2(const SamplingData& data, const float* positions, ColorRGBA* colors, size_t count, WrapMode wrap_mode)
+{
+    if (!can_use_simd(data))
+    {
+        sample_scalar(data, positions, colors, count, wrap_mode);
+        return;
+    }
+    switch (wrap_mode)
+    {
+    case WrapMode::Clamp:
+        return sample_sse2_impl<WrapMode::Clamp>(data, positions, colors, count);
+    case WrapMode::Repeat:
+        return sample_sse2_impl<WrapMode::Repeat>(data, positions, colors, count);
+    case WrapMode::MirrorRepeat:
+        return sample_sse2_impl<WrapMode::MirrorRepeat>(data, positions, colors, count);
+    default:
+        return sample_scalar(data, positions, colors, count, wrap_mode);
+    }
+}
+
+IMGG_TARGET("avx2")
+static auto fract_avx2(__m256 x) -> __m256
+{
+    return _mm256_sub_ps(x, _mm256_floor_ps(x));
+}
+
+template<WrapMode wrap_mode>
+IMGG_TARGET("avx2")
+static auto wrap_avx2(__m256 position) -> __m256
+{
+    switch (wrap_mode)
+    {
+    case WrapMode::Clamp:
+        return _mm256_min_ps(_mm256_max_ps(position, _mm256_setzero_ps()), _mm256_set1_ps(1.f));
+    case WrapMode::Repeat:
+        return fract_avx2(position);
+    case WrapMode::MirrorRepeat:
+    {
+        const __m256 modulo = _mm256_mul_ps(fract_avx2(_mm256_mul_ps(position, _mm256_set1_ps(0.5f))), _mm256_set1_ps(2.f));
+        return _mm256_sub_ps(_mm256_set1_ps(1.f), _mm256_andnot_ps(_mm256_set1_ps(-0.f), _mm256_sub_ps(modulo, _mm256_set1_ps(1.f))));
+    }
+    default:
+        return position;
+    }
+}
+
+template<WrapMode wrap_mode>
+IMGG_TARGET("avx2")
+static void sample_avx2_impl(const SamplingData& data, const float* positions, ColorRGBA* colors, size_t count)
+{
+    static constexpr int segment_stride = static_cast<int>(sizeof(Segment) / sizeof(float));
+    static_assert(sizeof(Segment) % sizeof(float) == 0, "We index the Segments as an array of floats");
+
+    const __m256i last_index = _mm256_set1_epi32(static_cast<int>(data.positions_count) - 1);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256 position = wrap_avx2<wrap_mode>(_mm256_loadu_ps(positions + i));
+
+        // Branchless binary search: all the lanes do the same number of steps.
+        __m256i base = _mm256_setzero_si256();
+        size_t  len  = data.positions_count;
+        while (len > 1)
+        {
+            const size_t  half  = len / 2;
+            const __m256i step  = _mm256_set1_epi32(static_cast<int>(half));
+            const __m256  probe = _mm256_i32gather_ps(data.positions, _mm256_add_epi32(base, step), 4);
+            base                = _mm256_add_epi32(base, _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(probe, position, _CMP_LT_OQ)), step));
+            len -= half;
+        }
+        const __m256  last_probe = _mm256_i32gather_ps(data.positions, base, 4);
+        const __m256i index      = _mm256_sub_epi32(base, _mm256_castps_si256(_mm256_cmp_ps(last_probe, position, _CMP_LT_OQ))); // The mask is -1 when true
+
+        // Detect the positions that are exactly on a mark.
+        const __m256 position_at_index = _mm256_i32gather_ps(data.positions, _mm256_min_epi32(index, last_index), 4);
+        const int    is_on_mark        = _mm256_movemask_ps(_mm256_and_ps(
+            _mm256_cmp_ps(position_at_index, position, _CMP_EQ_OQ),
+            _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_add_epi32(last_index, _mm256_set1_epi32(1)), index))
+        ));
+
+        const __m256i float_index   = _mm256_mullo_epi32(index, _mm256_set1_epi32(segment_stride));
+        const __m256  start         = _mm256_i32gather_ps(&data.segments->start, float_index, 4);
+        const __m256  inverse_width = _mm256_i32gather_ps(&data.segments->inverse_width, float_index, 4);
+        const __m256  t             = _mm256_mul_ps(_mm256_sub_ps(position, start), inverse_width);
+
+        alignas(32) int   indices[8];
+        alignas(32) float ts[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(indices), index);
+        _mm256_store_ps(ts, t);
+        for (int lane = 0; lane < 8; ++lane)
+        {
+            ColorRGBA& color = colors[i + static_cast<size_t>(lane)];
+            if (is_on_mark & (1 << lane))
+            {
+                color = data.colors_on_marks[indices[lane]];
+            }
+            else
+            {
+                const Segment& segment = data.segments[indices[lane]];
+                _mm_storeu_ps(reinterpret_cast<float*>(&color), segment_color_sse2(segment, segment.bias(ts[lane])));
+            }
+        }
+    }
+    _mm256_zeroupper(); // The compiler doesn't always do it before jumping to non-AVX code, and the scalar code (and whatever runs after the kernel) would be much slower
+    sample_scalar_impl<wrap_mode>(data, positions + i, colors + i, count - i);
+}
+
+void sample_avx2(const SamplingData& data, const float* positions, ColorRGBA* colors, size_t count, WrapMode wrap_mode)
+{
+    if (!can_use_simd(data))
+    {
+        sample_scalar(data, positions, colors, count, wrap_mode);
+        return;
+    }
+    switch (wrap_mode)
+    {
+    case WrapMode::Clamp:
+        return sample_avx2_impl<WrapMode::Clamp>(data, positions, colors, count);
+    case WrapMode::Repeat:
+        return sample_avx2_impl<WrapMode::Repeat>(data, positions, colors, count);
+    case WrapMode::MirrorRepeat:
+        return sample_avx2_impl<WrapMode::MirrorRepeat>(data, positions, colors, count);
+    default:
+        return sample_scalar(data, positions, colors, count, wrap_mode);
+    }
+}
+
+template<WrapMode wrap_mode>
+IMGG_TARGET("sse2")
+static void step_sse2_impl(const StepData& data, const float* positions, uint32_t* palette_indices, size_t count)
+{
+    const __m128 cells_count = _mm_set1_ps(data.cells_count);
+    const __m128 last_cell   = _mm_set1_ps(data.cells_count - 1.f);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 position = wrap_sse2<wrap_mode>(_mm_loadu_ps(positions + i));
+        const __m128 cell     = _mm_min_ps(_mm_mul_ps(position, cells_count), last_cell); // Returns `last_cell` for NaNs, like `step_cell()`
+
+        alignas(16) int   cells[4];
+        alignas(16) float wrapped_positions[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(cells), _mm_cvttps_epi32(cell));
+        _mm_store_ps(wrapped_positions, position);
+        for (size_t lane = 0; lane < 4; ++lane) // SSE2 has no gather instruction
+        {
+            palette_indices[i + lane] = step_palette_index(data, static_cast<uint32_t>(cells[lane]), wrapped_positions[lane]);
+        }
+    }
+    step_scalar_impl<wrap_mode>(data, positions + i, palette_indices + i, count - i);
+}
+
+void step_sse2(const StepData& data, const float* positions, uint32_t* palette_indices, size_t count, WrapMode wrap_mode)
+{
+    if (!can_use_simd(data))
+    {
+        step_scalar(data, positions, palette_indices, count, wrap_mode);
+        return;
+    }
+    switch (wrap_mode)
+    {
+    case WrapMode::Clamp:
+        return step_sse2_impl<WrapMode::Clamp>(data, positions, palette_indices, count);
+    case WrapMode::Repeat:
+        return step_sse2_impl<WrapMode::Repeat>(data, positions, palette_indices, count);
+    case WrapMode::MirrorRepeat:
+        return step_sse2_impl<WrapMode::MirrorRepeat>(data, positions, palette_indices, count);
+    default:
+        return step_scalar(data, positions, palette_indices, count, wrap_mode);
+    }
+}
+
+template<WrapMode wrap_mode>
+IMGG_TARGET("avx2")
+static void step_avx2_impl(const StepData& data, const float* positions, uint32_t* palette_indices, size_t count)
+{
+    const __m256 cells_count = _mm256_set1_ps(data.cells_count);
+    const __m256 last_cell   = _mm256_set1_ps(data.cells_count - 1.f);
+    const auto*  cells       = reinterpret_cast<const int*>(data.cells);
+    const auto*  palette     = reinterpret_cast<const int*>(data.palette_indices);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256  position = wrap_avx2<wrap_mode>(_mm256_loadu_ps(positions + i));
+        const __m256i cell     = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_mul_ps(position, cells_count), last_cell)); // Returns `last_cell` for NaNs, like `step_cell()`
+
+        // All the lanes do the same number of steps, and stop moving once they have reached a position that is not smaller than theirs (at the latest the +infinity).
+        __m256i index = _mm256_i32gather_epi32(cells, cell, 4);
+        for (uint32_t step = 0; step < data.max_marks_per_cell; ++step)
+        {
+            const __m256 probe = _mm256_i32gather_ps(data.positions, index, 4);
+            index              = _mm256_sub_epi32(index, _mm256_castps_si256(_mm256_cmp_ps(probe, position, _CMP_LT_OQ))); // The mask is -1 when true
+        }
+        const __m256  probe   = _mm256_i32gather_ps(data.positions, index, 4);
+        const __m256i on_mark = _mm256_castps_si256(_mm256_cmp_ps(probe, position, _CMP_EQ_OQ));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(palette_indices + i), _mm256_i32gather_epi32(palette, _mm256_sub_epi32(_mm256_add_epi32(index, index), on_mark), 4));
+    }
+    _mm256_zeroupper(); // See sample_avx2_impl()
+    step_scalar_impl<wrap_mode>(data, positions + i, palette_indices + i, count - i);
+}
+
+void step_avx2(const StepData& data, const float* positions, uint32_t* palette_indices, size_t count, WrapMode wrap_mode)
+{
+    if (!can_use_simd(data))
+    {
+        step_scalar(data, positions, palette_indices, count, wrap_mode);
+        return;
+    }
+    switch (wrap_mode)
+    {
+    case WrapMode::Clamp:
+        return step_avx2_impl<WrapMode::Clamp>(data, positions, palette_indices, count);
+    case WrapMode::Repeat:
+        return step_avx2_impl<WrapMode::Repeat>(data, positions, palette_indices, count);
+    case WrapMode::MirrorRepeat:
+        return step_avx2_impl<WrapMode::MirrorRepeat>(data, positions, palette_indices, count);
+    default:
+        return step_scalar(data, positions, palette_indices, count, wrap_mode);
+    }
+}
+
+template<WrapMode wrap_mode>
+IMGG_TARGET("avx2")
+static void multi_sample_avx2_impl(const PackedSamplingData& data, const uint32_t* gradient_indices, const float* positions, ColorRGBA* colors, size_t count)
+{
+    const auto* offsets          = reinterpret_cast<const int*>(data.offsets);
+    const auto* positions_counts = reinterpret_cast<const int*>(data.positions_counts);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256i gradient = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(gradient_indices + i));
+        const __m256  position = wrap_avx2<wrap_mode>(_mm256_loadu_ps(positions + i));
+        const __m256i offset   = _mm256_i32gather_epi32(offsets, gradient, 4);
+
+        // Branchless binary search: each lane searches its own gradient, and all the lanes do as many steps as the biggest gradient needs.
+        // The lanes whose gradient is smaller reach a length of 1 earlier, and then stop moving because their `half` is 0.
+        __m256i base = offset;
+        __m256i len  = _mm256_i32gather_epi32(positions_counts, gradient, 4);
+        for (uint32_t max_len = data.max_positions_count; max_len > 1; max_len -= max_len / 2)
+        {
+            const __m256i half  = _mm256_srli_epi32(len, 1);
+            const __m256  probe = _mm256_i32gather_ps(data.positions, _mm256_add_epi32(base, half), 4);
+            base                = _mm256_add_epi32(base, _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(probe, position, _CMP_LT_OQ)), half));
+            len                 = _mm256_sub_epi32(len, half);
+        }
+        const __m256  last_probe = _mm256_i32gather_ps(data.positions, base, 4); // The +infinity after the positions when the gradient is empty
+        const __m256i index      = _mm256_sub_epi32(_mm256_sub_epi32(base, offset), _mm256_castps_si256(_mm256_cmp_ps(last_probe, position, _CMP_LT_OQ))); // The mask is -1 when true
+
+        alignas(32) int   indices[8];
+        alignas(32) float wrapped_positions[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(indices), index);
+        _mm256_store_ps(wrapped_positions, position);
+        for (size_t lane = 0; lane < 8; ++lane)
+        {
+            const SamplingData gradient_data = sampling_data_of(data, gradient_indices[i + lane]);
+            colors[i + lane]                 = from_color_space(color_at(gradient_data, static_cast<size_t>(indices[lane]), wrapped_positions[lane]), gradient_data.color_space);
+        }
+    }
+    _mm256_zeroupper(); // See sample_avx2_impl()
+    multi_sample_scalar_impl<wrap_mode>(data, gradient_indices + i, positions + i, colors + i, count - i);
+}
+
+void multi_sample_avx2(const PackedSamplingData& data, const uint32_t* gradient_indices, const float* positions, ColorRGBA* colors, size_t count, WrapMode wrap_mode)
+{
+    switch (wrap_mode)
+    {
+    case WrapMode::Clamp:
+        return multi_sample_avx2_impl<WrapMode::Clamp>(data, gradient_indices, positions, colors, count);
+    case WrapMode::Repeat:
+        return multi_sample_avx2_impl<WrapMode::Repeat>(data, gradient_indices, positions, colors, count);
+    case WrapMode::MirrorRepeat:
+        return multi_sample_avx2_impl<WrapMode::MirrorRepeat>(data, gradient_indices, positions, colors, count);
+    default:
+        return multi_sample_scalar(data, gradient_indices, positions, colors, count, wrap_mode);
+    }
+}
+
+#endif
+
+#if IMGG_ARCH_ARM64
+
+/// Same as `InterpolationPolicy<Interpolation::Cubic>::segment_color()`.
+static auto segment_color_neon(const Segment& segment, float t) -> float32x4_t
+{
+    const float32x4_t quadratic = vaddq_f32(vld1q_f32(reinterpret_cast<const float*>(&segment.quadratic)), vmulq_n_f32(vld1q_f32(reinterpret_cast<const float*>(&segment.cubic)), t));
+    const float32x4_t slope     = vaddq_f32(vld1q_f32(reinterpret_cast<const float*>(&segment.slope)), vmulq_n_f32(quadratic, t));
+    return vaddq_f32(vld1q_f32(reinterpret_cast<const float*>(&segment.color)), vmulq_n_f32(slope, t));
+}
+
+static auto fract_neon(float32x4_t x) -> float32x4_t
+{
+    return vsubq_f32(x, vrndmq_f32(x));
+}
+
+template<WrapMode wrap_mode>
+static auto wrap_neon(float32x4_t position) -> float32x4_t
+{
+    switch (wrap_mode)
+    {
+    case WrapMode::Clamp:
+        return vminnmq_f32(vmaxnmq_f32(position, vdupq_n_f32(0.f)), vdupq_n_f32(1.f)); // The "nm" variants ignore NaNs, like std::fmin() and std::fmax()
+    case WrapMode::Repeat:
+        return fract_neon(position);
+    case WrapMode::MirrorRepeat:
+    {
+        const float32x4_t modulo = vmulq_f32(fract_neon(vmulq_f32(position, vdupq_n_f32(0.5f))), vdupq_n_f32(2.f));
+        return vsubq_f32(vdupq_n_f32(1.f), vabsq_f32(vsubq_f32(modulo, vdupq_n_f32(1.f))));
+    }
+    default:
+        return position;
+    }
+}
+
+template<WrapMode wrap_mode>
+static void sample_neon_impl(const SamplingData& data, const float* positions, ColorRGBA* colors, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const float32x4_t position = wrap_neon<wrap_mode>(vld1q_f32(positions + i));
+
+        // Branchless binary search: all the lanes do the same number of steps.
+        uint32x4_t base = vdupq_n_u32(0);
+        size_t     len  = data.positions_count;
+        while (len > 1)
+        {
+            const size_t     half = len / 2;
+            const uint32x4_t step = vdupq_n_u32(static_cast<uint32_t>(half));
+            uint32_t         probe_indices[4];
+            vst1q_u32(probe_indices, vaddq_u32(base, step));
+            const float probe_values[4] = { // NEON has no gather instruction
+                data.positions[probe_indices[0]],
+                data.positions[probe_indices[1]],
+                data.positions[probe_indices[2]],
+                data.positions[probe_indices[3]],
+            };
+            base = vaddq_u32(base, vandq_u32(vcltq_f32(vld1q_f32(probe_values), position), step));
+            len -= half;
+        }
+
+        uint32_t bases[4];
+        float    wrapped_positions[4];
+        vst1q_u32(bases, base);
+        vst1q_f32(wrapped_positions, position);
+        for (size_t lane = 0; lane < 4; ++lane)
+        {
+            const size_t index = bases[lane] + (data.positions[bases[lane]] < wrapped_positions[lane] ? 1 : 0);
+            ColorRGBA&   color = colors[i + lane];
+            if (index < data.positions_count && data.positions[index] == wrapped_positions[lane])
+            {
+                color = data.colors_on_marks[index];
+                continue;
+            }
+            const Segment& segment = data.segments[index];
+            vst1q_f32(reinterpret_cast<float*>(&color), segment_color_neon(segment, segment_t(segment, wrapped_positions[lane])));
+        }
+    }
+    sample_scalar_impl<wrap_mode>(data, positions + i, colors + i, count - i);
+}
+
+void sample_neon(const SamplingData& data, const float* positions, ColorRGBA* colors, size_t count, WrapMode wrap_mode)
+{
+    if (!can_use_simd(data))
+    {
+        sample_scalar(data, positions, colors, count, wrap_mode);
+        return;
+    }
+    switch (wrap_mode)
+    {
+    case WrapMode::Clamp:
+        return sample_neon_impl<WrapMode::Clamp>(data, positions, colors, count);
+    case WrapMode::Repeat:
+        return sample_neon_impl<WrapMode::Repeat>(data, positions, colors, count);
+    case WrapMode::MirrorRepeat:
+        return sample_neon_impl<WrapMode::MirrorRepeat>(data, positions, colors, count);
+    default:
+        return sample_scalar(data, positions, colors, count, wrap_mode);
+    }
+}
+
+template<WrapMode wrap_mode>
+static void step_neon_impl(const StepData& data, const float* positions, uint32_t* palette_indices, size_t count)
+{
+    const float32x4_t last_cell = vdupq_n_f32(data.cells_count - 1.f);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const float32x4_t position = wrap_neon<wrap_mode>(vld1q_f32(positions + i));
+        const float32x4_t cell     = vminnmq_f32(vmulq_n_f32(position, data.cells_count), last_cell); // Returns `last_cell` for NaNs, like `step_cell()`
+
+        uint32_t cells[4];
+        float    wrapped_positions[4];
+        vst1q_u32(cells, vcvtq_u32_f32(cell));
+        vst1q_f32(wrapped_positions, position);
+        for (size_t lane = 0; lane < 4; ++lane) // NEON has no gather instruction
+        {
+            palette_indices[i + lane] = step_palette_index(data, cells[lane], wrapped_positions[lane]);
+        }
+    }
+    step_scalar_impl<wrap_mode>(data, positions + i, palette_indices + i, count - i);
+}
+
+void step_neon(const StepData& data, const float* positions, uint32_t* palette_indices, size_t count, WrapMode wrap_mode)
+{
+    if (!can_use_simd(data))
+    {
+        step_scalar(data, positions, palette_indices, count, wrap_mode);
+        return;
+    }
+    switch (wrap_mode)
+    {
+    case WrapMode::Clamp:
+        return step_neon_impl<WrapMode::Clamp>(data, positions, palette_indices, count);
+    case WrapMode::Repeat:
+        return step_neon_impl<WrapMode::Repeat>(data, positions, palette_indices, count);
+    case WrapMode::MirrorRepeat:
+        return step_neon_impl<WrapMode::MirrorRepeat>(data, positions, palette_indices, count);
+    default:
+        return step_scalar(data, positions, palette_indices, count, wrap_mode);
+    }
+}
+
+#endif
+
+auto sample_kernel(InstructionSet instruction_set) -> SampleKernel
+{
+    switch (instruction_set)
+    {
+#if IMGG_ARCH_X86
+    case InstructionSet::SSE2:
+        return &sample_sse2;
+    case InstructionSet::AVX2:
+        return &sample_avx2;
+#endif
+#if IMGG_ARCH_ARM64
+    case InstructionSet::NEON:
+        return &sample_neon;
+#endif
+    default:
+        return &sample_scalar;
+    }
+}
+
+auto step_kernel(InstructionSet instruction_set) -> StepKernel
+{
+    switch (instruction_set)
+    {
+#if IMGG_ARCH_X86
+    case InstructionSet::SSE2:
+        return &step_sse2;
+    case InstructionSet::AVX2:
+        return &step_avx2;
+#endif
+#if IMGG_ARCH_ARM64
+    case InstructionSet::NEON:
+        return &step_neon;
+#endif
+    default:
+        return &step_scalar;
+    }
+}
+
+auto multi_sample_kernel(InstructionSet instruction_set) -> MultiSampleKernel
+{
+    switch (instruction_set)
+    {
+#if IMGG_ARCH_X86
+    case InstructionSet::AVX2:
+        return &multi_sample_avx2;
+#endif
+    default:
+        return &multi_sample_scalar;
+    }
+}
+
+}} // namespace ImGG::internal
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "SamplingData.hpp"
+#include "WrapMode.hpp"
+#include "cpu_features.hpp"
+
+namespace ImGG { namespace internal {
+
+/// Samples the gradient at `count` positions, after mapping them into the [0, 1] range according to `wrap_mode`.
+/// The colors are left in `data.color_space`.
+using SampleKernel = void (*)(const SamplingData& data, const float* positions, ColorRGBA* colors, size_t count, WrapMode wrap_mode);
+
+void sample_scalar(const SamplingData& data, const float* positions, ColorRGBA* colors, size_t count, WrapMode wrap_mode);
+#if IMGG_ARCH_X86
+void sample_sse2(const SamplingData& data, const float* positions, ColorRGBA* colors, size_t count, WrapMode wrap_mode);
+void sample_avx2(const SamplingData& data, const float* positions, ColorRGBA* colors, size_t count, WrapMode wrap_mode);
+#endif
+#if IMGG_ARCH_ARM64
+void sample_neon(const SamplingData& data, const float* positions, ColorRGBA* colors, size_t count, WrapMode wrap_mode);
+#endif
+
+/// Returns the kernel written for `instruction_set`, or the scalar one if this build doesn't have it.
+/// NB: it doesn't check that the CPU supports `instruction_set`, use `is_supported()` for that.
+auto sample_kernel(InstructionSet instruction_set) -> SampleKernel;
+
+/// Writes the index in the palette of the color at each of the `count` positions, after mapping them into the [0, 1] range according to `wrap_mode`.
+using StepKernel = void (*)(const StepData& data, const float* positions, uint32_t* palette_indices, size_t count, WrapMode wrap_mode);
+
+void step_scalar(const StepData& data, const float* positions, uint32_t* palette_indices, size_t count, WrapMode wrap_mode);
+#if IMGG_ARCH_X86
+void step_sse2(const StepData& data, const float* positions, uint32_t* palette_indices, size_t count, WrapMode wrap_mode);
+void step_avx2(const StepData& data, const float* positions, uint32_t* palette_indices, size_t count, WrapMode wrap_mode);
+#endif
+#if IMGG_ARCH_ARM64
+void step_neon(const StepData& data, const float* positions, uint32_t* palette_indices, size_t count, WrapMode wrap_mode);
+#endif
+
+/// Returns the step kernel written for `instruction_set`, or the scalar one if this build doesn't have it.
+/// NB: it doesn't check that the CPU supports `instruction_set`, use `is_supported()` for that.
+auto step_kernel(InstructionSet instruction_set) -> StepKernel;
+
+/// Samples gradient `gradient_indices[i]` of `data` at `positions[i]`, after mapping it into the [0, 1] range according to `wrap_mode`.
+/// Unlike the other kernels, the colors are converted back to sRGB, because each gradient can have its own color space.
+using MultiSampleKernel = void (*)(const PackedSamplingData& data, const uint32_t* gradient_indices, const float* positions, ColorRGBA* colors, size_t count, WrapMode wrap_mode);
+
+void multi_sample_scalar(const PackedSamplingData& data, const uint32_t* gradient_indices, const float* positions, ColorRGBA* colors, size_t count, WrapMode wrap_mode);
+#if IMGG_ARCH_X86
+void multi_sample_avx2(const PackedSamplingData& data, const uint32_t* gradient_indices, const float* positions, ColorRGBA* colors, size_t count, WrapMode wrap_mode);
+#endif
+
+/// Returns the multi-gradient kernel written for `instruction_set`, or the scalar one if this build doesn't have it.
+/// Only AVX2 has one, because the other instruction sets don't have the gather instructions that the searches in many different gradients need.
+/// NB: it doesn't check that the CPU supports `instruction_set`, use `is_supported()` for that.
+auto multi_sample_kernel(InstructionSet instruction_set) -> MultiSampleKernel;
+
+}} // namespace ImGG::internal
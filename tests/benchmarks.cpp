@@ -0,0 +1,306 @@
+// Build in Release and run this executable to compare the different ways of sampling a gradient.
+
+#include <imgui_gradient/imgui_gradient.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "../src/sample_kernels.hpp"
+
+/// Runs `function` a few times and returns the duration of the fastest run, in nanoseconds per sample.
+template<typename Function>
+static auto measure(size_t samples_count, Function&& function) -> double
+{
+    double best = 1e30;
+    for (int run = 0; run < 5; ++run)
+    {
+        const auto begin = std::chrono::steady_clock::now();
+        function();
+        const auto end = std::chrono::steady_clock::now();
+        best           = std::min(best, std::chrono::duration<double, std::nano>(end - begin).count());
+    }
+    return best / static_cast<double>(samples_count);
+}
+
+static void print_result(const char* name, double nanoseconds_per_sample, double reference)
+{
+    std::printf("  %-40s %8.2f ns/sample  (x%.1f)\n", name, nanoseconds_per_sample, reference / nanoseconds_per_sample);
+}
+
+/// Prevents the compiler from optimizing away the computations whose results we don't use.
+static auto checksum(const std::vector<ImGG::ColorRGBA>& colors) -> float
+{
+    float sum = 0.f;
+    for (const auto& color : colors)
+        sum += color.x + color.y + color.z + color.w;
+    return sum;
+}
+
+static auto random_gradient(size_t marks_count, std::default_random_engine& rng) -> ImGG::Gradient
+{
+    auto distribution = std::uniform_real_distribution<float>{0.f, 1.f};
+
+    ImGG::Gradient gradient{};
+    gradient.clear();
+    for (size_t i = 0; i < marks_count; ++i)
+    {
+        gradient.add_mark({ImGG::RelativePosition{distribution(rng)}, ImGG::ColorRGBA{distribution(rng), distribution(rng), distribution(rng), 1.f}});
+    }
+    return gradient;
+}
+
+static void benchmark_sampling(size_t marks_count)
+{
+    static constexpr size_t samples_count = 1 << 20;
+    static constexpr auto   wrap_mode     = ImGG::WrapMode::Repeat;
+
+    auto       rng          = std::default_random_engine{1};
+    auto       distribution = std::uniform_real_distribution<float>{-2.f, 2.f};
+    const auto gradient     = random_gradient(marks_count, rng);
+    const auto compiled     = gradient.compile();
+
+    std::vector<float> positions(samples_count);
+    for (auto& position : positions)
+        position = distribution(rng);
+    std::vector<ImGG::ColorRGBA> colors(samples_count);
+    float                        sum = 0.f;
+
+    std::printf("Sampling %zu random positions in a gradient with %zu marks:\n", samples_count, marks_count);
+
+    const double reference = measure(samples_count, [&]() {
+        for (size_t i = 0; i < samples_count; ++i)
+            colors[i] = gradient.at(ImGG::RelativePosition{positions[i], wrap_mode});
+        sum += checksum(colors);
+    });
+    print_result("Gradient::at()", reference, reference);
+
+    print_result("Gradient::at<Repeat, Linear>()", measure(samples_count, [&]() {
+                     for (size_t i = 0; i < samples_count; ++i)
+                         colors[i] = gradient.at<wrap_mode, ImGG::Interpolation::Linear>(positions[i]);
+                     sum += checksum(colors);
+                 }),
+                 reference);
+
+    print_result("CompiledGradient::at()", measure(samples_count, [&]() {
+                     for (size_t i = 0; i < samples_count; ++i)
+                         colors[i] = compiled.at(ImGG::RelativePosition{positions[i], wrap_mode});
+                     sum += checksum(colors);
+                 }),
+                 reference);
+
+    print_result("CompiledGradient::at<Repeat, Linear>()", measure(samples_count, [&]() {
+                     for (size_t i = 0; i < samples_count; ++i)
+                         colors[i] = compiled.at<wrap_mode, ImGG::Interpolation::Linear>(positions[i]);
+                     sum += checksum(colors);
+                 }),
+                 reference);
+
+    const std::pair<ImGG::internal::InstructionSet, const char*> instruction_sets[] = {
+        {ImGG::internal::InstructionSet::Scalar, "sample() - Scalar"},
+        {ImGG::internal::InstructionSet::SSE2, "sample() - SSE2"},
+        {ImGG::internal::InstructionSet::AVX2, "sample() - AVX2"},
+        {ImGG::internal::InstructionSet::NEON, "sample() - NEON"},
+    };
+    for (const auto& instruction_set : instruction_sets)
+    {
+        if (!ImGG::internal::is_supported(instruction_set.first))
+            continue;
+        const auto kernel = ImGG::internal::sample_kernel(instruction_set.first);
+        print_result(instruction_set.second, measure(samples_count, [&]() {
+                         kernel(compiled.sampling_data(), positions.data(), colors.data(), samples_count, wrap_mode);
+                         sum += checksum(colors);
+                     }),
+                     reference);
+    }
+
+    std::printf("  (checksum: %f)\n\n", static_cast<double>(sum));
+}
+
+static void benchmark_sorted_sampling(size_t marks_count)
+{
+    static constexpr size_t samples_count = 1 << 20;
+
+    auto       rng      = std::default_random_engine{1};
+    const auto compiled = random_gradient(marks_count, rng).compile();
+
+    std::vector<float> positions(samples_count);
+    for (size_t i = 0; i < samples_count; ++i)
+        positions[i] = static_cast<float>(i) / static_cast<float>(samples_count);
+    std::vector<ImGG::ColorRGBA> colors(samples_count);
+    float                        sum = 0.f;
+
+    std::printf("Sampling increasing positions with %zu marks:\n", marks_count);
+    const double reference = measure(samples_count, [&]() {
+        for (size_t i = 0; i < samples_count; ++i)
+            colors[i] = compiled.at(ImGG::RelativePosition{positions[i]});
+        sum += checksum(colors);
+    });
+    print_result("CompiledGradient::at", reference, reference);
+    print_result("GradientCursor::at", measure(samples_count, [&]() {
+                     auto cursor = ImGG::GradientCursor{compiled};
+                     for (size_t i = 0; i < samples_count; ++i)
+                         colors[i] = cursor.at(ImGG::RelativePosition{positions[i]});
+                     sum += checksum(colors);
+                 }),
+                 reference);
+    print_result("sample_sorted()", measure(samples_count, [&]() {
+                     compiled.sample_sorted(positions.data(), colors.data(), samples_count);
+                     sum += checksum(colors);
+                 }),
+                 reference);
+
+    std::printf("  (checksum: %f)\n\n", static_cast<double>(sum));
+}
+
+static void benchmark_color_space(size_t marks_count)
+{
+    static constexpr size_t samples_count = 1 << 20;
+
+    auto rng               = std::default_random_engine{1};
+    auto gradient          = random_gradient(marks_count, rng);
+    gradient.color_space() = ImGG::ColorSpace::OKLab;
+    const auto compiled    = gradient.compile();
+
+    auto               distribution = std::uniform_real_distribution<float>{0.f, 1.f};
+    std::vector<float> positions(samples_count);
+    for (auto& position : positions)
+        position = distribution(rng);
+    std::vector<ImGG::ColorRGBA> colors(samples_count);
+    float                        sum = 0.f;
+
+    std::printf("Sampling in OKLab with %zu marks:\n", marks_count);
+    const double reference = measure(samples_count, [&]() {
+        for (size_t i = 0; i < samples_count; ++i)
+            colors[i] = gradient.at(ImGG::RelativePosition{positions[i]});
+        sum += checksum(colors);
+    });
+    print_result("Gradient::at", reference, reference);
+    print_result("CompiledGradient::sample()", measure(samples_count, [&]() {
+                     compiled.sample(positions.data(), colors.data(), samples_count, ImGG::WrapMode::Clamp);
+                     sum += checksum(colors);
+                 }),
+                 reference);
+    print_result("CompiledGradient::bake()", measure(samples_count, [&]() {
+                     compiled.bake(colors.data(), samples_count);
+                     sum += checksum(colors);
+                 }),
+                 reference);
+
+    std::printf("  (checksum: %f)\n\n", static_cast<double>(sum));
+}
+
+static void benchmark_colormap()
+{
+    static constexpr size_t width  = 3840;
+    static constexpr size_t height = 2160;
+
+    auto       rng          = std::default_random_engine{1};
+    auto       distribution = std::uniform_real_distribution<float>{0.f, 1.f};
+    const auto compiled     = random_gradient(8, rng).compile();
+
+    std::vector<float> image(width * height);
+    for (auto& value : image)
+        value = distribution(rng);
+    std::vector<ImGG::ColorRGBA> colors(width * height);
+    float                        sum = 0.f;
+
+    std::printf("Colormapping a %zux%zu image:\n", width, height);
+    ImGG::ThreadPool single_thread{1};
+    const double     reference = measure(width * height, [&]() {
+        ImGG::colormap(compiled, image.data(), width, height, width, ImGG::WrapMode::Clamp, colors.data(), single_thread);
+        sum += checksum(colors);
+    });
+    print_result("colormap() - 1 thread", reference, reference);
+
+    auto& all_threads = ImGG::default_thread_pool();
+    char  name[64];
+    std::snprintf(name, sizeof(name), "colormap() - %zu threads", all_threads.threads_count());
+    print_result(name, measure(width * height, [&]() {
+                     ImGG::colormap(compiled, image.data(), width, height, width, ImGG::WrapMode::Clamp, colors.data(), all_threads);
+                     sum += checksum(colors);
+                 }),
+                 reference);
+    if (all_threads.threads_count() == 1)
+        std::printf("  (only one core: the scaling with the number of threads can't be measured on this machine)\n");
+
+    std::printf("  (checksum: %f)\n\n", static_cast<double>(sum));
+}
+
+static void benchmark_integer_colormap()
+{
+    static constexpr size_t width  = 3840;
+    static constexpr size_t height = 2160;
+
+    auto       rng      = std::default_random_engine{1};
+    const auto gradient = random_gradient(8, rng);
+
+    std::vector<uint16_t> image(width * height);
+    for (auto& value : image)
+        value = static_cast<uint16_t>(rng());
+    std::vector<ImU32> colors(width * height);
+    ImU32              sum = 0;
+
+    std::printf("Colormapping a %zux%zu 16-bit image on 1 thread:\n", width, height);
+    ImGG::ThreadPool single_thread{1};
+    const auto       compiled  = gradient.compile();
+    const double     reference = measure(width * height, [&]() { // What you would do without IntegerColormap
+        std::vector<float> normalized(width * height);
+        for (size_t i = 0; i < image.size(); ++i)
+            normalized[i] = static_cast<float>(image[i]) / 65535.f;
+        ImGG::colormap_rgba8(compiled, normalized.data(), width, height, width, ImGG::WrapMode::Clamp, colors.data(), single_thread);
+        sum += colors.back();
+    });
+    print_result("Convert to float + colormap_rgba8()", reference, reference);
+
+    const auto integer_colormap = ImGG::IntegerColormap16{gradient};
+    print_result("IntegerColormap16", measure(width * height, [&]() {
+                     ImGG::colormap_rgba8(integer_colormap, image.data(), width, height, width, colors.data(), single_thread);
+                     sum += colors.back();
+                 }),
+                 reference);
+
+    std::printf("  (checksum: %u)\n\n", sum);
+}
+
+static void benchmark_inverse_colormap(size_t marks_count)
+{
+    static constexpr size_t width  = 1920;
+    static constexpr size_t height = 1080;
+
+    auto       rng          = std::default_random_engine{1};
+    auto       distribution = std::uniform_real_distribution<float>{0.f, 1.f};
+    const auto compiled     = random_gradient(marks_count, rng).compile();
+
+    // A colormapped image, where the neighbouring pixels don't have the same color
+    std::vector<float> values(width * height);
+    for (auto& value : values)
+        value = distribution(rng);
+    std::vector<ImU32> image(width * height);
+    ImGG::colormap_rgba8(compiled, values.data(), width, height, width, ImGG::WrapMode::Clamp, image.data());
+
+    std::printf("Inverting a %zux%zu image with %zu marks:\n", width, height, marks_count);
+    const auto beginning = std::chrono::steady_clock::now();
+    const auto inverse   = ImGG::InverseColormap{compiled};
+    const auto end       = std::chrono::steady_clock::now();
+    std::printf("  %-40s %8.2f ms\n", "InverseColormap construction", std::chrono::duration<double, std::milli>(end - beginning).count());
+
+    std::vector<ImGG::InverseColormapResult> results(width * height);
+    const double                             nanoseconds = measure(width * height, [&]() {
+        inverse.find_rgba8(image.data(), results.data(), image.size());
+    });
+    std::printf("  %-40s %8.2f ns/pixel  (%.0f ms per image)\n\n", "find_rgba8()", nanoseconds, nanoseconds * width * height / 1e6);
+}
+
+auto main() -> int
+{
+    for (const size_t marks_count : std::vector<size_t>{2, 8, 64, 256})
+        benchmark_sampling(marks_count);
+    for (const size_t marks_count : std::vector<size_t>{8, 256})
+        benchmark_sorted_sampling(marks_count);
+    benchmark_color_space(8);
+    benchmark_colormap();
+    benchmark_integer_colormap();
+    for (const size_t marks_count : std::vector<size_t>{8, 64})
+        benchmark_inverse_colormap(marks_count);
+}
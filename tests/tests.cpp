@@ -2,10 +2,19 @@
 #include <doctest/doctest.h>
 #include <imgui_gradient/imgui_gradient.hpp>
 #include <quick_imgui/quick_imgui.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
 #include <random>
+#include <vector>
 #include "../generated/checkboxes_for_all_flags.inl"
 #include "../src/Utils.hpp" // to test wrap mode functions
 #include "../src/button_disabled.hpp"
+#include "../src/color_conversions.hpp" // to test the conversions between color spaces
+#include "../src/half_float.hpp"    // to test the conversions to half floats
+#include "../src/imgui_internal.hpp" // to use ImLerp
+#include "../src/sample_kernels.hpp"  // to test all the SIMD code paths
 
 auto main(int argc, char* argv[]) -> int
 {
@@ -47,7 +56,7 @@ auto main(int argc, char* argv[]) -> int
             {
                 if (ImGui::Button("Remove a mark"))
                 {
-                    gradient.gradient().remove_mark(ImGG::MarkId{gradient.gradient().get_marks().front()});
+                    gradient.gradient().remove_mark(gradient.gradient().id_of(gradient.gradient().get_marks().front()));
                 }
             }
             if (ImGui::Button("Add a mark"))
@@ -58,7 +67,7 @@ auto main(int argc, char* argv[]) -> int
             if (ImGui::Button("Set mark position") && !gradient.gradient().is_empty())
             {
                 gradient.gradient().set_mark_position(
-                    ImGG::MarkId{gradient.gradient().get_marks().front()},
+                    gradient.gradient().id_of(gradient.gradient().get_marks().front()),
                     ImGG::RelativePosition{position}
                 );
             };
@@ -69,7 +78,7 @@ auto main(int argc, char* argv[]) -> int
             static auto color = ImVec4{0.f, 0.f, 0.f, 1.f};
             if (ImGui::Button("Set mark color") && !gradient.gradient().is_empty())
             {
-                gradient.gradient().set_mark_color(ImGG::MarkId{gradient.gradient().get_marks().front()}, color);
+                gradient.gradient().set_mark_color(gradient.gradient().id_of(gradient.gradient().get_marks().front()), color);
             };
             ImGui::SameLine();
             ImGui::ColorEdit4(
@@ -183,6 +192,1556 @@ TEST_CASE("Interpolation modes")
     CHECK(doctest::Approx(gradient.at(ImGG::RelativePosition{0.75f}).x) == 1.f);
 }
 
+static auto is_same_color(const ImGG::ColorRGBA& a, const ImGG::ColorRGBA& b) -> bool
+{
+    return ImGG::operator==(a, b); // ColorRGBA is an alias for ImVec4, so argument-dependent lookup can't find ImGG::operator==
+}
+
+static auto is_approx_same_color(const ImGG::ColorRGBA& a, const ImGG::ColorRGBA& b) -> bool
+{
+    return doctest::Approx(a.x) == b.x
+           && doctest::Approx(a.y) == b.y
+           && doctest::Approx(a.z) == b.z
+           && doctest::Approx(a.w) == b.w;
+}
+
+/// Creates a gradient with `marks_count` marks with random positions and colors.
+static auto random_gradient(size_t marks_count, std::default_random_engine& rng) -> ImGG::Gradient
+{
+    auto distribution = std::uniform_real_distribution<float>{0.f, 1.f};
+
+    ImGG::Gradient gradient{};
+    gradient.clear();
+    for (size_t i = 0; i < marks_count; ++i)
+    {
+        gradient.add_mark({ImGG::RelativePosition{distribution(rng)}, ImGG::ColorRGBA{distribution(rng), distribution(rng), distribution(rng), distribution(rng)}});
+    }
+    return gradient;
+}
+
+/// Positions that are worth testing for the given gradient: the bounds, each mark, and random positions in-between.
+static auto positions_to_test(const ImGG::Gradient& gradient, std::default_random_engine& rng) -> std::vector<float>
+{
+    auto distribution = std::uniform_real_distribution<float>{0.f, 1.f};
+
+    std::vector<float> positions{0.f, 0.5f, 1.f};
+    for (const auto& mark : gradient.get_marks())
+        positions.push_back(mark.position.get()); // Exactly on a mark
+    for (int i = 0; i < 1000; ++i)
+        positions.push_back(distribution(rng));
+    return positions;
+}
+
+/// The linear scan that `Gradient::at()` used before it started binary searching the marks.
+static auto reference_at(const ImGG::Gradient& gradient, const ImGG::RelativePosition position) -> ImGG::ColorRGBA
+{
+    const ImGG::Mark* lower{nullptr};
+    const ImGG::Mark* upper{nullptr};
+    for (const ImGG::Mark& mark : gradient.get_marks())
+    {
+        if (mark.position > position && (!upper || mark.position < upper->position))
+            upper = &mark;
+        if (mark.position < position && (!lower || mark.position > lower->position))
+            lower = &mark;
+    }
+    if (!lower && !upper)
+        return ImGG::ColorRGBA{0.f, 0.f, 0.f, 1.f};
+    if (!lower)
+        return upper->color;
+    if (!upper)
+        return lower->color;
+    if (gradient.interpolation_mode() == ImGG::Interpolation::Constant)
+        return upper->color;
+    return ImLerp(lower->color, upper->color, (position.get() - lower->position.get()) / (upper->position.get() - lower->position.get()));
+}
+
+TEST_CASE("at() gives the same result as a linear scan of the marks")
+{
+    auto rng      = std::default_random_engine{42};
+    auto gradient = random_gradient(200, rng);
+    // Marks sharing the same position
+    gradient.add_mark({ImGG::RelativePosition{0.5f}, ImGG::ColorRGBA{1.f, 0.f, 0.f, 1.f}});
+    gradient.add_mark({ImGG::RelativePosition{0.5f}, ImGG::ColorRGBA{0.f, 1.f, 0.f, 1.f}});
+    const auto positions = positions_to_test(gradient, rng);
+
+    for (const auto interpolation : {ImGG::Interpolation::Linear, ImGG::Interpolation::Constant})
+    {
+        gradient.interpolation_mode() = interpolation;
+        for (const float position : positions)
+        {
+            CHECK(is_same_color(gradient.at(ImGG::RelativePosition{position}), reference_at(gradient, ImGG::RelativePosition{position})));
+        }
+    }
+
+    // Still works after copying, removing and moving marks
+    ImGG::Gradient copy{gradient};
+    copy.remove_mark(copy.id_of(copy.get_marks().front()));
+    copy.set_mark_position(copy.id_of(copy.get_marks().back()), ImGG::RelativePosition{0.25f});
+    for (const float position : positions)
+    {
+        CHECK(is_same_color(copy.at(ImGG::RelativePosition{position}), reference_at(copy, ImGG::RelativePosition{position})));
+    }
+}
+
+TEST_CASE("Mark ids")
+{
+    auto rng          = std::default_random_engine{43};
+    auto distribution = std::uniform_int_distribution<int>{0, 4}; // Few distinct positions, so that many marks share the same one
+
+    SUBCASE("Ids follow their marks")
+    {
+        auto gradient = ImGG::Gradient{};
+        gradient.clear();
+        std::vector<ImGG::MarkId> ids;
+        for (int i = 0; i < 20; ++i)
+            ids.push_back(gradient.add_mark({ImGG::RelativePosition{static_cast<float>(distribution(rng)) / 4.f}, ImGG::ColorRGBA{static_cast<float>(i), 0.f, 0.f, 1.f}}));
+        for (int i = 0; i < 20; ++i)
+            gradient.set_mark_position(ids[static_cast<size_t>(i)], ImGG::RelativePosition{static_cast<float>(distribution(rng)) / 4.f});
+        gradient.remove_mark(ids[3]);
+        gradient.remove_mark(ids[11]);
+        const auto new_id = gradient.add_mark({ImGG::RelativePosition{0.5f}, ImGG::ColorRGBA{100.f, 0.f, 0.f, 1.f}}); // Reuses the slot of a removed mark
+
+        CHECK(!gradient.contains(ids[3]));
+        CHECK(!gradient.contains(ids[11]));
+        CHECK(new_id != ids[3]);
+        CHECK(new_id != ids[11]);
+        CHECK(gradient.find(new_id)->color.x == 100.f);
+        CHECK(!gradient.contains(ImGG::MarkId{}));
+        for (size_t i = 0; i < 20; ++i)
+        {
+            if (i == 3 || i == 11)
+                continue;
+            REQUIRE(gradient.contains(ids[i]));
+            CHECK(gradient.find(ids[i])->color.x == static_cast<float>(i));
+            CHECK(gradient.id_of(*gradient.find(ids[i])) == ids[i]);
+        }
+
+        // A copy gives the same ids to its marks
+        auto copy = gradient;
+        copy.set_mark_color(ids[5], ImGG::ColorRGBA{0.f, 1.f, 0.f, 1.f});
+        CHECK(copy.find(ids[5])->color.y == 1.f);
+        CHECK(gradient.find(ids[5])->color.y == 0.f);
+
+        gradient.clear();
+        CHECK(!gradient.contains(ids[0]));
+        CHECK(!gradient.contains(new_id));
+        CHECK(copy.contains(ids[0]));
+    }
+
+    SUBCASE("The marks are sorted like a stable sort would do")
+    {
+        auto gradient = ImGG::Gradient{};
+        auto ids      = std::vector<ImGG::MarkId>{gradient.id_of(gradient.get_marks()[0]), gradient.id_of(gradient.get_marks()[1])};
+        for (int i = 0; i < 30; ++i)
+            ids.push_back(gradient.add_mark({ImGG::RelativePosition{static_cast<float>(distribution(rng)) / 4.f}, ImGG::ColorRGBA{static_cast<float>(i), 0.f, 0.f, 1.f}}));
+        for (int i = 0; i < 200; ++i)
+        {
+            const auto id       = ids[std::uniform_int_distribution<size_t>{0, ids.size() - 1}(rng)];
+            const auto position = ImGG::RelativePosition{static_cast<float>(distribution(rng)) / 4.f};
+            auto       expected = gradient.get_marks();
+            expected[static_cast<size_t>(gradient.find(id) - gradient.get_marks().data())].position = position;
+            std::stable_sort(expected.begin(), expected.end(), [](const ImGG::Mark& a, const ImGG::Mark& b) { return a.position < b.position; });
+
+            gradient.set_mark_position(id, position);
+            CHECK(gradient.get_marks() == expected);
+            CHECK(gradient.find(id)->position == position);
+        }
+    }
+}
+
+TEST_CASE("Small gradients are stored inline")
+{
+    const auto is_inside = [](const void* pointer, const ImGG::Gradient& gradient) {
+        return static_cast<const char*>(pointer) >= reinterpret_cast<const char*>(&gradient)
+               && static_cast<const char*>(pointer) < reinterpret_cast<const char*>(&gradient + 1);
+    };
+
+    auto rng      = std::default_random_engine{47};
+    auto gradient = random_gradient(ImGG::Gradient::inline_marks_count, rng);
+    CHECK(gradient.get_marks().is_inline());
+    CHECK(is_inside(gradient.get_marks().data(), gradient));
+    const auto copy = gradient;
+    CHECK(is_inside(copy.get_marks().data(), copy));
+    CHECK(copy == gradient);
+    const auto moved = std::move(gradient);
+    CHECK(is_inside(moved.get_marks().data(), moved));
+    CHECK(moved == copy);
+    CHECK(ImGG::Gradient{}.get_marks().is_inline());
+
+    // Spills to the heap when it grows, and comes back inline when copied small again
+    auto big = copy;
+    big.add_mark({ImGG::RelativePosition{0.5f}, ImGG::ColorRGBA{1.f, 0.f, 0.f, 1.f}});
+    CHECK(!big.get_marks().is_inline());
+    for (size_t i = 0; i < big.get_marks().size(); ++i)
+        CHECK(big.get_marks()[i].position.get() >= (i == 0 ? 0.f : big.get_marks()[i - 1].position.get()));
+    auto big_copy = big;
+    CHECK(big_copy == big);
+    big = copy;
+    CHECK(big == copy);
+}
+
+TEST_CASE("SmallVector")
+{
+    using Vector = ImGG::internal::SmallVector<int, 4>;
+    auto vector  = Vector{1, 2, 3};
+    auto mirror  = std::vector<int>{1, 2, 3};
+    auto rng     = std::default_random_engine{53};
+    for (int i = 0; i < 1000; ++i)
+    {
+        const auto index = std::uniform_int_distribution<size_t>{0, mirror.size()}(rng);
+        if (!mirror.empty() && rng() % 3 == 0)
+        {
+            const auto erase_index = index == mirror.size() ? index - 1 : index;
+            vector.erase(vector.begin() + erase_index);
+            mirror.erase(mirror.begin() + static_cast<std::ptrdiff_t>(erase_index));
+        }
+        else
+        {
+            vector.insert(vector.begin() + index, i);
+            mirror.insert(mirror.begin() + static_cast<std::ptrdiff_t>(index), i);
+        }
+        REQUIRE(vector.size() == mirror.size());
+        CHECK(std::equal(vector.begin(), vector.end(), mirror.begin()));
+        CHECK(vector.is_inline() == (vector.capacity() == 4));
+
+        const auto copy  = vector;
+        auto       moved = Vector{};
+        moved            = Vector{copy};
+        CHECK(copy == vector);
+        CHECK(moved == vector);
+        CHECK(copy.is_inline() == (vector.size() <= 4));
+    }
+
+    // Inserting one of its own elements while growing
+    auto full = Vector{1, 2, 3, 4};
+    full.insert(full.begin(), full[3]);
+    CHECK(full == Vector{4, 1, 2, 3, 4});
+}
+
+TEST_CASE("CompiledGradient gives the same result as Gradient")
+{
+    auto rng = std::default_random_engine{7};
+    for (const size_t marks_count : std::vector<size_t>{0, 1, 2, 3, 50})
+    {
+        auto gradient = random_gradient(marks_count, rng);
+        if (marks_count > 2)
+        {
+            // Marks sharing the same position
+            gradient.add_mark({ImGG::RelativePosition{0.5f}, ImGG::ColorRGBA{1.f, 0.f, 0.f, 1.f}});
+            gradient.add_mark({ImGG::RelativePosition{0.5f}, ImGG::ColorRGBA{0.f, 1.f, 0.f, 1.f}});
+        }
+        const auto positions = positions_to_test(gradient, rng);
+
+        for (const auto interpolation : {ImGG::Interpolation::Linear, ImGG::Interpolation::Constant, ImGG::Interpolation::Cubic})
+        {
+            gradient.interpolation_mode() = interpolation;
+            const auto compiled           = gradient.compile();
+            for (const float position : positions)
+            {
+                CHECK(is_approx_same_color(compiled.at(ImGG::RelativePosition{position}), gradient.at(ImGG::RelativePosition{position})));
+            }
+        }
+    }
+}
+
+TEST_CASE("Baking a CompiledGradient")
+{
+    auto rng = std::default_random_engine{3};
+    for (const size_t marks_count : std::vector<size_t>{0, 1, 2, 50})
+    {
+        auto gradient = random_gradient(marks_count, rng);
+        gradient.add_mark({ImGG::RelativePosition{0.5f}, ImGG::ColorRGBA{1.f, 0.f, 0.f, 1.f}}); // Exactly on the center of a texel
+        for (const auto interpolation : {ImGG::Interpolation::Linear, ImGG::Interpolation::Constant, ImGG::Interpolation::Cubic})
+        {
+            gradient.interpolation_mode() = interpolation;
+            const auto compiled           = gradient.compile();
+            for (const size_t size : std::vector<size_t>{1, 2, 255, 256})
+            {
+                std::vector<ImGG::ColorRGBA> colors(size);
+                std::vector<ImU32>           packed_colors(size);
+                compiled.bake(colors.data(), size);
+                compiled.bake_rgba8(packed_colors.data(), size);
+                for (size_t i = 0; i < size; ++i)
+                {
+                    const auto position = ImGG::RelativePosition{(static_cast<float>(i) + 0.5f) / static_cast<float>(size)};
+                    CHECK(is_same_color(colors[i], compiled.at(position)));
+                    CHECK(is_approx_same_color(colors[i], gradient.at(position)));
+                    CHECK(packed_colors[i] == ImGui::ColorConvertFloat4ToU32(colors[i]));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Sampling many positions at once")
+{
+    auto rng          = std::default_random_engine{11};
+    auto distribution = std::uniform_real_distribution<float>{-3.f, 3.f};
+    for (const size_t marks_count : std::vector<size_t>{0, 1, 2, 3, 200})
+    {
+        auto gradient = random_gradient(marks_count, rng);
+        auto positions = positions_to_test(gradient, rng);
+        for (int i = 0; i < 1000; ++i)
+            positions.push_back(distribution(rng)); // Outside of the [0, 1] range
+        positions.push_back(-1.f);
+        positions.push_back(2.f);
+
+        for (const auto interpolation : {ImGG::Interpolation::Linear, ImGG::Interpolation::Constant, ImGG::Interpolation::Cubic})
+        {
+            gradient.interpolation_mode() = interpolation;
+            const auto compiled           = gradient.compile();
+            for (const auto wrap_mode : {ImGG::WrapMode::Clamp, ImGG::WrapMode::Repeat, ImGG::WrapMode::MirrorRepeat})
+            {
+                std::vector<ImGG::ColorRGBA> colors(positions.size());
+                compiled.sample(positions.data(), colors.data(), positions.size(), wrap_mode);
+                for (size_t i = 0; i < positions.size(); ++i)
+                {
+                    CHECK(is_approx_same_color(colors[i], gradient.at(ImGG::RelativePosition{positions[i], wrap_mode})));
+                }
+
+                for (const auto instruction_set : {ImGG::internal::InstructionSet::SSE2, ImGG::internal::InstructionSet::AVX2, ImGG::internal::InstructionSet::NEON})
+                {
+                    if (!ImGG::internal::is_supported(instruction_set))
+                        continue;
+                    std::vector<ImGG::ColorRGBA> simd_colors(positions.size());
+                    ImGG::internal::sample_kernel(instruction_set)(compiled.sampling_data(), positions.data(), simd_colors.data(), positions.size(), wrap_mode);
+                    for (size_t i = 0; i < positions.size(); ++i)
+                    {
+                        CHECK(is_approx_same_color(simd_colors[i], compiled.at(ImGG::RelativePosition{positions[i], wrap_mode})));
+                    }
+                }
+            }
+        }
+    }
+}
+
+template<ImGG::WrapMode wrap_mode, ImGG::Interpolation interpolation_mode>
+static void check_modes_known_at_compile_time(ImGG::Gradient gradient, const std::vector<float>& positions)
+{
+    gradient.interpolation_mode() = interpolation_mode;
+    const auto compiled           = gradient.compile();
+    for (const float position : positions)
+    {
+        CHECK(is_same_color(gradient.at<wrap_mode, interpolation_mode>(position), gradient.at(ImGG::RelativePosition{position, wrap_mode})));
+        CHECK(is_same_color(compiled.at<wrap_mode, interpolation_mode>(position), compiled.at(ImGG::RelativePosition{position, wrap_mode})));
+    }
+}
+
+TEST_CASE("Sampling with modes known at compile time")
+{
+    auto rng          = std::default_random_engine{5};
+    auto distribution = std::uniform_real_distribution<float>{-3.f, 3.f};
+    auto gradient     = random_gradient(20, rng);
+    auto positions    = positions_to_test(gradient, rng);
+    for (int i = 0; i < 100; ++i)
+        positions.push_back(distribution(rng)); // Outside of the [0, 1] range
+
+    check_modes_known_at_compile_time<ImGG::WrapMode::Clamp, ImGG::Interpolation::Linear>(gradient, positions);
+    check_modes_known_at_compile_time<ImGG::WrapMode::Clamp, ImGG::Interpolation::Constant>(gradient, positions);
+    check_modes_known_at_compile_time<ImGG::WrapMode::Repeat, ImGG::Interpolation::Linear>(gradient, positions);
+    check_modes_known_at_compile_time<ImGG::WrapMode::Repeat, ImGG::Interpolation::Constant>(gradient, positions);
+    check_modes_known_at_compile_time<ImGG::WrapMode::MirrorRepeat, ImGG::Interpolation::Linear>(gradient, positions);
+    check_modes_known_at_compile_time<ImGG::WrapMode::MirrorRepeat, ImGG::Interpolation::Constant>(gradient, positions);
+    check_modes_known_at_compile_time<ImGG::WrapMode::Clamp, ImGG::Interpolation::Cubic>(gradient, positions);
+    check_modes_known_at_compile_time<ImGG::WrapMode::Repeat, ImGG::Interpolation::Cubic>(gradient, positions);
+    check_modes_known_at_compile_time<ImGG::WrapMode::MirrorRepeat, ImGG::Interpolation::Cubic>(gradient, positions);
+}
+
+TEST_CASE("Custom interpolation policies")
+{
+    using Smoothstep = ImGG::EasedInterpolation<ImGG::Smoothstep>;
+
+    SUBCASE("The easing remaps the blend factor")
+    {
+        const auto gradient = ImGG::Gradient{};
+        CHECK(is_approx_same_color(gradient.at<ImGG::WrapMode::Clamp, Smoothstep>(0.25f), ImGG::ColorRGBA{0.15625f, 0.15625f, 0.15625f, 1.f}));
+        CHECK(is_approx_same_color(gradient.at<ImGG::WrapMode::Clamp, Smoothstep>(0.5f), ImGG::ColorRGBA{0.5f, 0.5f, 0.5f, 1.f}));
+        CHECK(is_approx_same_color(gradient.compile().at<ImGG::WrapMode::Clamp, Smoothstep>(0.25f), ImGG::ColorRGBA{0.15625f, 0.15625f, 0.15625f, 1.f}));
+    }
+
+    SUBCASE("CompiledGradient gives the same result as Gradient")
+    {
+        auto rng      = std::default_random_engine{71};
+        auto gradient = random_gradient(20, rng);
+        for (const auto color_space : {ImGG::ColorSpace::sRGB, ImGG::ColorSpace::OKLab})
+        {
+            gradient.color_space() = color_space;
+            const auto compiled    = gradient.compile();
+            auto distribution = std::uniform_real_distribution<float>{-2.f, 2.f};
+            for (int i = 0; i < 1000; ++i)
+            {
+                const float position = distribution(rng); // Exactly on a mark, the compiled gradient returns the color of Interpolation::Linear
+                CHECK(is_approx_same_color(compiled.at<ImGG::WrapMode::MirrorRepeat, Smoothstep>(position), gradient.at<ImGG::WrapMode::MirrorRepeat, Smoothstep>(position)));
+            }
+        }
+    }
+
+    SUBCASE("Baking and sampling many positions at once")
+    {
+        auto       rng      = std::default_random_engine{72};
+        const auto compiled = random_gradient(20, rng).compile();
+
+        std::vector<ImGG::ColorRGBA> baked(100);
+        compiled.bake<Smoothstep>(baked.data(), baked.size());
+        for (size_t i = 0; i < baked.size(); ++i)
+            CHECK(is_same_color(baked[i], compiled.at<ImGG::WrapMode::Clamp, Smoothstep>(ImGG::internal::texel_center(i, baked.size()))));
+
+        auto distribution = std::uniform_real_distribution<float>{-2.f, 2.f};
+        auto positions    = std::vector<float>(100);
+        for (auto& position : positions)
+            position = distribution(rng);
+        std::vector<ImGG::ColorRGBA> sampled(positions.size());
+        compiled.sample<Smoothstep>(positions.data(), sampled.data(), positions.size(), ImGG::WrapMode::Repeat);
+        for (size_t i = 0; i < positions.size(); ++i)
+            CHECK(is_same_color(sampled[i], compiled.at<ImGG::WrapMode::Repeat, Smoothstep>(positions[i])));
+    }
+}
+
+TEST_CASE("Colormapping an image with several threads")
+{
+    auto       rng          = std::default_random_engine{13};
+    auto       distribution = std::uniform_real_distribution<float>{-1.5f, 1.5f};
+    const auto compiled     = random_gradient(20, rng).compile();
+
+    // Sizes that are not multiples of the tiles, with some padding at the end of each row
+    const size_t       width      = 2500;
+    const size_t       height     = 37;
+    const size_t       row_stride = 2503;
+    std::vector<float> image(row_stride * height);
+    for (auto& value : image)
+        value = distribution(rng);
+
+    ImGG::ThreadPool single_thread{1};
+    ImGG::ThreadPool many_threads{4};
+    for (const auto wrap_mode : {ImGG::WrapMode::Clamp, ImGG::WrapMode::Repeat, ImGG::WrapMode::MirrorRepeat})
+    {
+        std::vector<ImGG::ColorRGBA> reference(width * height);
+        std::vector<ImGG::ColorRGBA> colors(width * height);
+        std::vector<ImU32>           packed_colors(width * height);
+        ImGG::colormap(compiled, image.data(), width, height, row_stride, wrap_mode, reference.data(), single_thread);
+        ImGG::colormap(compiled, image.data(), width, height, row_stride, wrap_mode, colors.data(), many_threads);
+        ImGG::colormap_rgba8(compiled, image.data(), width, height, row_stride, wrap_mode, packed_colors.data(), many_threads);
+        for (size_t y = 0; y < height; ++y)
+        {
+            for (size_t x = 0; x < width; ++x)
+            {
+                const size_t i = y * width + x;
+                CHECK(is_same_color(colors[i], reference[i]));
+                CHECK(is_approx_same_color(reference[i], compiled.at(ImGG::RelativePosition{image[y * row_stride + x], wrap_mode})));
+                CHECK(packed_colors[i] == ImGui::ColorConvertFloat4ToU32(reference[i]));
+            }
+        }
+    }
+}
+
+TEST_CASE("Colormapping integer data")
+{
+    auto rng      = std::default_random_engine{17};
+    auto gradient = random_gradient(10, rng);
+
+    ImGG::IntegerColormap8  colormap8{gradient};
+    ImGG::IntegerColormap16 colormap16{gradient};
+    const auto              check_tables = [&]() {
+        const auto compiled = gradient.compile();
+        for (size_t i = 0; i < ImGG::IntegerColormap8::table_size; ++i)
+            CHECK(colormap8(static_cast<uint8_t>(i)) == ImGui::ColorConvertFloat4ToU32(compiled.at(ImGG::RelativePosition{static_cast<float>(i) / 255.f})));
+        for (size_t i = 0; i < ImGG::IntegerColormap16::table_size; i += 97)
+            CHECK(colormap16(static_cast<uint16_t>(i)) == ImGui::ColorConvertFloat4ToU32(compiled.at(ImGG::RelativePosition{static_cast<float>(i) / 65535.f})));
+    };
+    check_tables();
+
+    SUBCASE("The tables are only rebuilt when the gradient changes")
+    {
+        CHECK(!colormap8.update(gradient));
+        gradient.find(gradient.id_of(gradient.get_marks().front()))->color = ImGG::ColorRGBA{0.1f, 0.2f, 0.3f, 0.4f};
+        CHECK(colormap8.update(gradient));
+        CHECK(colormap16.update(gradient));
+        check_tables();
+        gradient.interpolation_mode() = ImGG::Interpolation::Constant;
+        CHECK(colormap8.update(gradient));
+        CHECK(colormap16.update(gradient));
+        CHECK(!colormap8.update(gradient));
+        check_tables();
+    }
+
+    SUBCASE("Changing only the color space rebuilds the tables")
+    {
+        gradient.color_space() = ImGG::ColorSpace::OKLab;
+        CHECK(colormap8.update(gradient));
+        CHECK(colormap16.update(gradient));
+        CHECK(!colormap8.update(gradient));
+        check_tables();
+    }
+
+    SUBCASE("Images")
+    {
+        const size_t          width      = 1500;
+        const size_t          height     = 20;
+        const size_t          row_stride = 1501;
+        std::vector<uint8_t>  image8(row_stride * height);
+        std::vector<uint16_t> image16(row_stride * height);
+        for (size_t i = 0; i < image8.size(); ++i)
+        {
+            image8[i]  = static_cast<uint8_t>(rng());
+            image16[i] = static_cast<uint16_t>(rng());
+        }
+
+        ImGG::ThreadPool   thread_pool{3};
+        std::vector<ImU32> colors8(width * height);
+        std::vector<ImU32> colors16(width * height);
+        ImGG::colormap_rgba8(colormap8, image8.data(), width, height, row_stride, colors8.data(), thread_pool);
+        ImGG::colormap_rgba8(colormap16, image16.data(), width, height, row_stride, colors16.data(), thread_pool);
+        for (size_t y = 0; y < height; ++y)
+        {
+            for (size_t x = 0; x < width; ++x)
+            {
+                CHECK(colors8[y * width + x] == colormap8(image8[y * row_stride + x]));
+                CHECK(colors16[y * width + x] == colormap16(image16[y * row_stride + x]));
+            }
+        }
+    }
+}
+
+TEST_CASE("Step gradient")
+{
+    auto rng          = std::default_random_engine{29};
+    auto distribution = std::uniform_real_distribution<float>{-3.f, 3.f};
+
+    SUBCASE("Same colors as the CompiledGradient")
+    {
+        auto clustered = random_gradient(0, rng); // Many marks in a single cell
+        for (int i = 0; i < 50; ++i)
+            clustered.add_mark({ImGG::RelativePosition{0.5f + static_cast<float>(i) * 1e-6f}, ImGG::ColorRGBA{static_cast<float>(i) / 50.f, 0.f, 1.f, 1.f}});
+        auto gradients = std::vector<ImGG::Gradient>{clustered};
+        for (const size_t marks_count : std::vector<size_t>{0, 1, 2, 3, 200})
+            gradients.push_back(random_gradient(marks_count, rng));
+
+        for (auto& gradient : gradients)
+        {
+            gradient.interpolation_mode() = ImGG::Interpolation::Constant;
+            const auto compiled           = gradient.compile();
+            const auto step_gradient      = ImGG::StepGradient{gradient};
+            auto       positions          = positions_to_test(gradient, rng);
+            for (int i = 0; i < 1000; ++i)
+                positions.push_back(distribution(rng)); // Outside of the [0, 1] range
+
+            for (const auto wrap_mode : {ImGG::WrapMode::Clamp, ImGG::WrapMode::Repeat, ImGG::WrapMode::MirrorRepeat})
+            {
+                std::vector<ImGG::ColorRGBA> colors(positions.size());
+                std::vector<ImU32>           packed_colors(positions.size());
+                step_gradient.sample(positions.data(), colors.data(), positions.size(), wrap_mode);
+                step_gradient.sample_rgba8(positions.data(), packed_colors.data(), positions.size(), wrap_mode);
+                for (size_t i = 0; i < positions.size(); ++i)
+                {
+                    const auto expected = compiled.at(ImGG::RelativePosition{positions[i], wrap_mode});
+                    CHECK(is_same_color(step_gradient.at(ImGG::RelativePosition{positions[i], wrap_mode}), expected));
+                    CHECK(is_same_color(colors[i], expected));
+                    CHECK(packed_colors[i] == ImGui::ColorConvertFloat4ToU32(expected));
+                }
+
+                for (const auto instruction_set : {ImGG::internal::InstructionSet::SSE2, ImGG::internal::InstructionSet::AVX2, ImGG::internal::InstructionSet::NEON})
+                {
+                    if (!ImGG::internal::is_supported(instruction_set))
+                        continue;
+                    std::vector<uint32_t> indices(positions.size());
+                    ImGG::internal::step_kernel(instruction_set)(step_gradient.step_data(), positions.data(), indices.data(), positions.size(), wrap_mode);
+                    for (size_t i = 0; i < positions.size(); ++i)
+                        CHECK(indices[i] == step_gradient.palette_index(ImGG::RelativePosition{positions[i], wrap_mode}));
+                }
+            }
+        }
+    }
+
+    SUBCASE("The palette has each color once")
+    {
+        const auto red      = ImGG::ColorRGBA{1.f, 0.f, 0.f, 1.f};
+        const auto blue     = ImGG::ColorRGBA{0.f, 0.f, 1.f, 1.f};
+        auto       gradient = ImGG::Gradient{std::list<ImGG::Mark>{
+            ImGG::Mark{ImGG::RelativePosition{0.f}, red},
+            ImGG::Mark{ImGG::RelativePosition{0.25f}, blue},
+            ImGG::Mark{ImGG::RelativePosition{0.5f}, red},
+            ImGG::Mark{ImGG::RelativePosition{1.f}, blue},
+        }};
+        gradient.interpolation_mode() = ImGG::Interpolation::Constant;
+        const auto step_gradient      = ImGG::StepGradient{gradient};
+        REQUIRE(step_gradient.palette().size() == 2);
+        CHECK(is_same_color(step_gradient.palette()[0], red));
+        CHECK(is_same_color(step_gradient.palette()[1], blue));
+        CHECK(step_gradient.palette_index(ImGG::RelativePosition{0.1f}) == 1);
+        CHECK(step_gradient.palette_index(ImGG::RelativePosition{0.3f}) == 0);
+        CHECK(step_gradient.palette_index(ImGG::RelativePosition{0.25f}) == 0); // Exactly on a mark, we get the color of the next one
+    }
+
+    SUBCASE("Images")
+    {
+        auto gradient                 = random_gradient(12, rng);
+        gradient.interpolation_mode() = ImGG::Interpolation::Constant;
+        const auto step_gradient      = ImGG::StepGradient{gradient};
+
+        const size_t       width      = 1500;
+        const size_t       height     = 20;
+        const size_t       row_stride = 1501;
+        std::vector<float> image(row_stride * height);
+        for (auto& value : image)
+            value = distribution(rng);
+
+        ImGG::ThreadPool      thread_pool{3};
+        std::vector<uint32_t> indices(width * height);
+        std::vector<ImU32>    packed_colors(width * height);
+        ImGG::colormap_indices(step_gradient, image.data(), width, height, row_stride, ImGG::WrapMode::Repeat, indices.data(), thread_pool);
+        ImGG::colormap_rgba8(step_gradient, image.data(), width, height, row_stride, ImGG::WrapMode::Repeat, packed_colors.data(), thread_pool);
+        for (size_t y = 0; y < height; ++y)
+        {
+            for (size_t x = 0; x < width; ++x)
+            {
+                const auto position = ImGG::RelativePosition{image[y * row_stride + x], ImGG::WrapMode::Repeat};
+                CHECK(indices[y * width + x] == step_gradient.palette_index(position));
+                CHECK(packed_colors[y * width + x] == step_gradient.palette_rgba8()[step_gradient.palette_index(position)]);
+            }
+        }
+    }
+}
+
+static auto random_keyframes(size_t keyframes_count, std::default_random_engine& rng) -> std::vector<ImGG::Keyframe>
+{
+    auto                        distribution = std::uniform_real_distribution<float>{0.f, 10.f};
+    std::vector<ImGG::Keyframe> keyframes;
+    for (size_t i = 0; i < keyframes_count; ++i)
+    {
+        auto gradient                 = random_gradient(1 + i * 3, rng);
+        gradient.interpolation_mode() = i % 2 == 0 ? ImGG::Interpolation::Linear : ImGG::Interpolation::Cubic;
+        gradient.color_space()        = i % 3 == 0 ? ImGG::ColorSpace::sRGB : ImGG::ColorSpace::OKLab;
+        keyframes.push_back(ImGG::Keyframe{distribution(rng), gradient});
+    }
+    return keyframes;
+}
+
+TEST_CASE("Keyframed gradient")
+{
+    auto        rng          = std::default_random_engine{37};
+    auto        distribution = std::uniform_real_distribution<float>{-1.f, 11.f};
+    const auto  keyframed    = ImGG::KeyframedGradient{random_keyframes(4, rng)};
+    const auto& keyframes    = keyframed.keyframes();
+    REQUIRE(std::is_sorted(keyframes.begin(), keyframes.end(), [](const ImGG::Keyframe& a, const ImGG::Keyframe& b) { return a.time < b.time; }));
+
+    SUBCASE("Same colors as blending the keyframes")
+    {
+        std::vector<float> positions{0.f, 0.5f, 1.f};
+        for (const auto& keyframe : keyframes)
+        {
+            for (const auto& mark : keyframe.gradient.get_marks())
+                positions.push_back(mark.position.get()); // Exactly on a mark of one of the keyframes
+        }
+        for (int i = 0; i < 200; ++i)
+            positions.push_back(std::uniform_real_distribution<float>{0.f, 1.f}(rng));
+
+        for (int i = 0; i < 50; ++i)
+        {
+            const float time     = distribution(rng);
+            const auto  upper    = std::upper_bound(keyframes.begin(), keyframes.end(), time, [](float t, const ImGG::Keyframe& keyframe) { return t < keyframe.time; });
+            const auto  lower    = upper == keyframes.begin() ? upper : upper - 1;
+            const auto  lower_at = lower->gradient.compile();
+            const auto  upper_at = upper == keyframes.end() || upper == keyframes.begin() ? lower_at : upper->gradient.compile();
+            const float factor   = upper == keyframes.end() || upper == keyframes.begin() ? 0.f : (time - lower->time) / (upper->time - lower->time);
+            for (const float position : positions)
+            {
+                const auto a = lower_at.at(ImGG::RelativePosition{position});
+                const auto b = upper_at.at(ImGG::RelativePosition{position});
+                CHECK(is_approx_same_color(keyframed.at(time, ImGG::RelativePosition{position}), ImLerp(a, b, factor)));
+            }
+        }
+        for (const auto& keyframe : keyframes)
+        {
+            const auto compiled = keyframe.gradient.compile();
+            for (const float position : positions)
+                CHECK(is_same_color(keyframed.at(keyframe.time, ImGG::RelativePosition{position}), compiled.at(ImGG::RelativePosition{position})));
+        }
+    }
+
+    SUBCASE("Baking")
+    {
+        auto bake = ImGG::KeyframedBake{keyframed, 64, 32};
+        for (size_t y = 0; y < bake.times_count(); ++y)
+        {
+            const float time = keyframed.start_time() + (static_cast<float>(y) + 0.5f) / 32.f * (keyframed.end_time() - keyframed.start_time());
+            for (size_t x = 0; x < bake.positions_count(); ++x)
+            {
+                const auto position = ImGG::RelativePosition{(static_cast<float>(x) + 0.5f) / 64.f};
+                CHECK(is_approx_same_color(bake.table()[y * 64 + x], keyframed.at(time, position)));
+                CHECK(is_approx_same_color(bake.at(time, position), bake.table()[y * 64 + x])); // On the centers of the texels, the bilinear filtering gives the texels themselves
+            }
+        }
+        CHECK(is_same_color(bake.at(-100.f, ImGG::RelativePosition{0.f}), bake.table()[0]));
+        CHECK(is_same_color(bake.at(100.f, ImGG::RelativePosition{1.f}), bake.table()[32 * 64 - 1]));
+
+        const auto range = bake.update(keyframed);
+        CHECK(range.begin == range.end); // Nothing changed
+
+        auto modified = keyframed;
+        modified.set_keyframe_gradient(1, random_gradient(5, rng));
+        const auto modified_range = bake.update(modified);
+        CHECK(modified_range.begin < modified_range.end);
+        CHECK(modified_range.end - modified_range.begin < 32);
+        const auto fresh_bake = ImGG::KeyframedBake{modified, 64, 32};
+        for (size_t i = 0; i < 64 * 32; ++i)
+            CHECK(is_same_color(bake.table()[i], fresh_bake.table()[i]));
+        CHECK(is_approx_same_color(modified.at(keyframes[1].time, ImGG::RelativePosition{0.3f}), modified.keyframes()[1].gradient.compile().at(ImGG::RelativePosition{0.3f})));
+    }
+}
+
+TEST_CASE("Sampling many gradients at once")
+{
+    auto rng          = std::default_random_engine{31};
+    auto distribution = std::uniform_real_distribution<float>{-1.5f, 1.5f};
+
+    auto gradients = std::vector<ImGG::Gradient>{};
+    for (const size_t marks_count : std::vector<size_t>{0, 1, 2, 3, 200, 7, 40})
+        gradients.push_back(random_gradient(marks_count, rng));
+    gradients[2].color_space()        = ImGG::ColorSpace::OKLab;
+    gradients[3].interpolation_mode() = ImGG::Interpolation::Cubic;
+    gradients[5].interpolation_mode() = ImGG::Interpolation::Constant;
+
+    auto packed = ImGG::PackedGradients{};
+    for (const auto& gradient : gradients)
+        packed.add(gradient);
+    REQUIRE(packed.size() == gradients.size());
+
+    const auto check_against_gradients = [&]() {
+        auto indices_distribution = std::uniform_int_distribution<uint32_t>{0, static_cast<uint32_t>(gradients.size() - 1)};
+
+        std::vector<uint32_t> gradient_indices;
+        std::vector<float>    positions;
+        for (int i = 0; i < 10000; ++i)
+        {
+            gradient_indices.push_back(indices_distribution(rng));
+            positions.push_back(distribution(rng));
+        }
+        for (uint32_t i = 0; i < gradients.size(); ++i)
+        {
+            for (const float position : positions_to_test(gradients[i], rng)) // Exactly on the marks, and right next to them
+            {
+                gradient_indices.push_back(i);
+                positions.push_back(position);
+            }
+        }
+
+        ImGG::ThreadPool many_threads{4};
+        for (const auto wrap_mode : {ImGG::WrapMode::Clamp, ImGG::WrapMode::Repeat, ImGG::WrapMode::MirrorRepeat})
+        {
+            std::vector<ImGG::ColorRGBA> colors(positions.size());
+            std::vector<ImGG::ColorRGBA> colors_in_parallel(positions.size());
+            packed.sample(gradient_indices.data(), positions.data(), colors.data(), positions.size(), wrap_mode);
+            packed.sample_in_parallel(gradient_indices.data(), positions.data(), colors_in_parallel.data(), positions.size(), wrap_mode, many_threads);
+            for (size_t i = 0; i < positions.size(); ++i)
+            {
+                const auto expected = gradients[gradient_indices[i]].compile().at(ImGG::RelativePosition{positions[i], wrap_mode});
+                CHECK(is_same_color(packed.at(gradient_indices[i], ImGG::RelativePosition{positions[i], wrap_mode}), expected));
+                CHECK(is_same_color(colors[i], expected));
+                CHECK(is_same_color(colors_in_parallel[i], expected));
+            }
+
+            for (const auto instruction_set : {ImGG::internal::InstructionSet::SSE2, ImGG::internal::InstructionSet::AVX2, ImGG::internal::InstructionSet::NEON})
+            {
+                if (!ImGG::internal::is_supported(instruction_set))
+                    continue;
+                std::vector<ImGG::ColorRGBA> simd_colors(positions.size());
+                ImGG::internal::multi_sample_kernel(instruction_set)(packed.packed_sampling_data(), gradient_indices.data(), positions.data(), simd_colors.data(), positions.size(), wrap_mode);
+                for (size_t i = 0; i < positions.size(); ++i)
+                    CHECK(is_same_color(simd_colors[i], colors[i]));
+            }
+        }
+    };
+
+    SUBCASE("Same colors as each Gradient")
+    {
+        check_against_gradients();
+    }
+
+    SUBCASE("Replacing a gradient")
+    {
+        gradients[4] = random_gradient(3, rng); // Fewer marks, the gradients after it move
+        packed.set(4, gradients[4]);
+        gradients[1] = random_gradient(300, rng); // More marks than all the other gradients
+        packed.set(1, gradients[1]);
+        gradients[6] = random_gradient(40, rng); // Same number of marks
+        packed.set(6, gradients[6]);
+        check_against_gradients();
+    }
+}
+
+TEST_CASE("Gradient atlas")
+{
+    auto rng       = std::default_random_engine{37};
+    auto gradients = std::vector<ImGG::Gradient>{};
+    for (const size_t marks_count : std::vector<size_t>{0, 1, 5, 20, 3, 8})
+        gradients.push_back(random_gradient(marks_count, rng));
+
+    auto atlas       = ImGG::GradientAtlasRGBA8{100};
+    auto float_atlas = ImGG::GradientAtlasRGBA{100};
+    for (size_t i = 0; i < gradients.size(); ++i)
+    {
+        CHECK(atlas.add(gradients[i]) == i);
+        CHECK(float_atlas.add(gradients[i]) == i);
+    }
+    REQUIRE(atlas.height() == gradients.size());
+
+    const auto check_rows = [&]() {
+        for (size_t row = 0; row < gradients.size(); ++row)
+        {
+            const auto                   compiled = gradients[row].compile();
+            std::vector<ImU32>           packed_colors(atlas.width());
+            std::vector<ImGG::ColorRGBA> colors(atlas.width());
+            compiled.bake_rgba8(packed_colors.data(), atlas.width());
+            compiled.bake(colors.data(), atlas.width());
+            for (size_t x = 0; x < atlas.width(); ++x)
+            {
+                CHECK(atlas.row(row)[x] == packed_colors[x]);
+                CHECK(atlas.data()[row * atlas.width() + x] == packed_colors[x]);
+                CHECK(is_same_color(float_atlas.row(row)[x], colors[x]));
+            }
+        }
+    };
+    check_rows();
+
+    // All the rows are new
+    auto dirty_rows = atlas.dirty_rows();
+    REQUIRE(dirty_rows.size() == 1);
+    CHECK(dirty_rows[0].begin == 0);
+    CHECK(dirty_rows[0].end == gradients.size());
+    atlas.clear_dirty_rows();
+    CHECK(atlas.dirty_rows().empty());
+
+    // Nothing has changed
+    for (size_t row = 0; row < gradients.size(); ++row)
+        CHECK(!atlas.update(row, gradients[row]));
+    CHECK(atlas.dirty_rows().empty());
+
+    gradients[1]                      = random_gradient(4, rng);
+    gradients[2].interpolation_mode() = ImGG::Interpolation::Constant;
+    gradients[4].color_space()        = ImGG::ColorSpace::OKLab;
+    for (size_t row = 0; row < gradients.size(); ++row)
+    {
+        CHECK(atlas.update(row, gradients[row]) == (row == 1 || row == 2 || row == 4));
+        float_atlas.update(row, gradients[row]);
+    }
+    check_rows();
+    dirty_rows = atlas.dirty_rows();
+    REQUIRE(dirty_rows.size() == 2);
+    CHECK(dirty_rows[0].begin == 1);
+    CHECK(dirty_rows[0].end == 3);
+    CHECK(dirty_rows[1].begin == 4);
+    CHECK(dirty_rows[1].end == 5);
+}
+
+TEST_CASE("Sampling coherent positions")
+{
+    auto rng          = std::default_random_engine{19};
+    auto distribution = std::uniform_real_distribution<float>{-0.02f, 0.03f};
+    for (const size_t marks_count : std::vector<size_t>{0, 1, 2, 50})
+    {
+        const auto gradient = random_gradient(marks_count, rng);
+        const auto compiled = gradient.compile();
+
+        // A random walk, with a few jumps and some positions exactly on the marks
+        auto positions = std::vector<float>{};
+        auto position  = 0.f;
+        for (int i = 0; i < 2000; ++i)
+        {
+            position = i % 500 == 0 ? 1.f - position : ImGG::internal::clamp_position(position + distribution(rng)).get();
+            positions.push_back(position);
+        }
+        for (const auto& mark : gradient.get_marks())
+            positions.push_back(mark.position.get());
+
+        auto cursor = ImGG::GradientCursor{compiled};
+        for (const float pos : positions)
+            CHECK(is_same_color(cursor.at(ImGG::RelativePosition{pos}), compiled.at(ImGG::RelativePosition{pos})));
+
+        positions.push_back(-1.f);
+        positions.push_back(2.f);
+        std::sort(positions.begin(), positions.end());
+        std::vector<ImGG::ColorRGBA> colors(positions.size());
+        compiled.sample_sorted(positions.data(), colors.data(), positions.size());
+        for (size_t i = 0; i < positions.size(); ++i)
+            CHECK(is_same_color(colors[i], compiled.at(ImGG::RelativePosition{positions[i], ImGG::WrapMode::Clamp})));
+    }
+}
+
+TEST_CASE("Choosing the size of a LUT")
+{
+    SUBCASE("Linear interpolation")
+    {
+        auto rng          = std::default_random_engine{23};
+        auto distribution = std::uniform_real_distribution<float>{0.f, 1.f};
+        for (const size_t marks_count : std::vector<size_t>{0, 1, 2, 5, 20})
+        {
+            const auto compiled = random_gradient(marks_count, rng).compile();
+            for (const float tolerance : {0.1f, 0.01f, 0.002f})
+            {
+                const auto bake_size = ImGG::choose_bake_size(compiled, tolerance);
+                CHECK(bake_size.estimated_error == ImGG::estimated_bake_error(compiled, bake_size.size));
+                if (bake_size.size == 4096)
+                    continue; // Some random marks are so close to each other that the tolerance can't be met
+                CHECK(bake_size.estimated_error <= tolerance);
+                if (bake_size.size > 1)
+                    CHECK(ImGG::estimated_bake_error(compiled, bake_size.size - 1) > tolerance);
+
+                // Check against the colors that the GPU would actually give
+                std::vector<ImGG::ColorRGBA> lut(bake_size.size);
+                compiled.bake(lut.data(), lut.size());
+                for (int i = 0; i < 1000; ++i)
+                {
+                    const float position = distribution(rng);
+                    const float texel    = std::min(std::max(position * static_cast<float>(lut.size()) - 0.5f, 0.f), static_cast<float>(lut.size() - 1));
+                    const auto  index    = std::min(static_cast<size_t>(texel), lut.size() - 1);
+                    const auto  filtered = ImLerp(lut[index], lut[std::min(index + 1, lut.size() - 1)], texel - static_cast<float>(index));
+                    const auto  expected = compiled.at(ImGG::RelativePosition{position});
+                    CHECK(std::abs(filtered.x - expected.x) <= tolerance + 0.0001f);
+                    CHECK(std::abs(filtered.y - expected.y) <= tolerance + 0.0001f);
+                    CHECK(std::abs(filtered.z - expected.z) <= tolerance + 0.0001f);
+                    CHECK(std::abs(filtered.w - expected.w) <= tolerance + 0.0001f);
+                }
+            }
+        }
+    }
+
+    SUBCASE("A black to white gradient only needs a few texels")
+    {
+        const auto compiled = ImGG::Gradient{}.compile();
+        CHECK(ImGG::choose_bake_size(compiled, 1.f / 255.f).size == 128); // The error is at the ends, where the LUT is clamped to the center of the first and last texels
+    }
+
+    SUBCASE("Constant interpolation needs a texel inside of each band")
+    {
+        auto gradient = ImGG::Gradient{std::list<ImGG::Mark>{
+            ImGG::Mark{ImGG::RelativePosition{0.f}, ImGG::ColorRGBA{0.f, 0.f, 0.f, 1.f}},
+            ImGG::Mark{ImGG::RelativePosition{0.5f}, ImGG::ColorRGBA{1.f, 0.f, 0.f, 1.f}},
+            ImGG::Mark{ImGG::RelativePosition{0.51f}, ImGG::ColorRGBA{0.f, 1.f, 0.f, 1.f}},
+            ImGG::Mark{ImGG::RelativePosition{1.f}, ImGG::ColorRGBA{0.f, 0.f, 1.f, 1.f}},
+        }};
+        gradient.interpolation_mode() = ImGG::Interpolation::Constant;
+        const auto compiled           = gradient.compile();
+        const auto bake_size          = ImGG::choose_bake_size(compiled, 0.f);
+        CHECK(bake_size.estimated_error == 0.f);
+
+        std::vector<ImGG::ColorRGBA> lut(bake_size.size);
+        compiled.bake(lut.data(), lut.size());
+        CHECK(std::any_of(lut.begin(), lut.end(), [](const ImGG::ColorRGBA& color) { return is_same_color(color, ImGG::ColorRGBA{0.f, 1.f, 0.f, 1.f}); }));
+        CHECK(ImGG::estimated_bake_error(compiled, 4) == 1.f);
+    }
+}
+
+TEST_CASE("Average color over an interval")
+{
+    auto rng          = std::default_random_engine{29};
+    auto distribution = std::uniform_real_distribution<float>{-2.5f, 2.5f};
+    for (const size_t marks_count : std::vector<size_t>{0, 1, 2, 7})
+    {
+        auto gradient = random_gradient(marks_count, rng);
+        for (const auto interpolation : {ImGG::Interpolation::Linear, ImGG::Interpolation::Constant, ImGG::Interpolation::Cubic})
+        {
+            gradient.interpolation_mode() = interpolation;
+            const auto compiled           = gradient.compile();
+            for (const auto wrap_mode : {ImGG::WrapMode::Clamp, ImGG::WrapMode::Repeat, ImGG::WrapMode::MirrorRepeat})
+            {
+                for (int i = 0; i < 20; ++i)
+                {
+                    const float a = distribution(rng);
+                    const float b = distribution(rng);
+
+                    // Supersample the interval
+                    static constexpr int samples_count = 20000;
+                    auto                 expected      = ImGG::ColorRGBA{0.f, 0.f, 0.f, 0.f};
+                    for (int sample = 0; sample < samples_count; ++sample)
+                    {
+                        const auto color = compiled.at(ImGG::RelativePosition{ImLerp(a, b, (static_cast<float>(sample) + 0.5f) / samples_count), wrap_mode});
+                        expected.x += color.x / samples_count;
+                        expected.y += color.y / samples_count;
+                        expected.z += color.z / samples_count;
+                        expected.w += color.w / samples_count;
+                    }
+
+                    const auto average = compiled.average(a, b, wrap_mode);
+                    CHECK(std::abs(average.x - expected.x) < 0.002f);
+                    CHECK(std::abs(average.y - expected.y) < 0.002f);
+                    CHECK(std::abs(average.z - expected.z) < 0.002f);
+                    CHECK(std::abs(average.w - expected.w) < 0.002f);
+                    CHECK(is_same_color(average, compiled.average(b, a, wrap_mode)));
+                }
+                CHECK(is_same_color(compiled.average(0.3f, 0.3f, wrap_mode), compiled.at(ImGG::RelativePosition{0.3f})));
+                CHECK(is_approx_same_color(compiled.average(0.3f, 0.3001f, wrap_mode), compiled.at(ImGG::RelativePosition{0.30005f}))); // Small intervals don't lose precision
+            }
+        }
+    }
+}
+
+TEST_CASE("Inverse colormap")
+{
+    auto rng          = std::default_random_engine{31};
+    auto distribution = std::uniform_real_distribution<float>{0.f, 1.f};
+    for (const size_t marks_count : std::vector<size_t>{0, 1, 2, 6, 40})
+    {
+        auto gradient = random_gradient(marks_count, rng);
+        for (const auto interpolation : {ImGG::Interpolation::Linear, ImGG::Interpolation::Constant})
+        {
+            gradient.interpolation_mode() = interpolation;
+            const auto compiled           = gradient.compile();
+            const auto inverse            = ImGG::InverseColormap{compiled};
+
+            // The colors of the gradient are found exactly
+            for (int i = 0; i < 200; ++i)
+            {
+                const auto color  = compiled.at(ImGG::RelativePosition{distribution(rng)});
+                const auto result = inverse.find(color);
+                CHECK(result.distance < 0.0001f);
+                CHECK(is_approx_same_color(compiled.at(ImGG::RelativePosition{result.position}), color));
+            }
+
+            // Any other color gets the closest position, which we compare to a brute force search
+            for (int i = 0; i < 200; ++i)
+            {
+                const auto color  = ImGG::ColorRGBA{distribution(rng), distribution(rng), distribution(rng), i % 2 == 0 ? 1.f : distribution(rng) * 1.5f};
+                const auto result = inverse.find(color);
+                const auto found  = compiled.at(ImGG::RelativePosition{result.position});
+                const auto distance_to = [&](const ImGG::ColorRGBA& other) {
+                    return std::sqrt((other.x - color.x) * (other.x - color.x) + (other.y - color.y) * (other.y - color.y) + (other.z - color.z) * (other.z - color.z) + (other.w - color.w) * (other.w - color.w));
+                };
+                CHECK(result.distance == doctest::Approx(distance_to(found)).epsilon(0.001));
+                for (int sample = 0; sample <= 2000; ++sample)
+                    CHECK(result.distance <= distance_to(compiled.at(ImGG::RelativePosition{static_cast<float>(sample) / 2000.f})) + 0.0001f);
+            }
+        }
+    }
+
+    SUBCASE("Images")
+    {
+        const auto         compiled = ImGG::Gradient{}.compile();
+        const auto         inverse  = ImGG::InverseColormap{compiled};
+        std::vector<ImU32> image    = {IM_COL32(0, 0, 0, 255), IM_COL32(0, 0, 0, 255), IM_COL32(51, 51, 51, 255), IM_COL32(255, 255, 255, 255)};
+        std::vector<ImGG::InverseColormapResult> results(image.size());
+        inverse.find_rgba8(image.data(), results.data(), image.size());
+        CHECK(results[0].position == doctest::Approx(0.f));
+        CHECK(results[1].position == doctest::Approx(0.f));
+        CHECK(results[2].position == doctest::Approx(0.2f));
+        CHECK(results[3].position == doctest::Approx(1.f));
+    }
+}
+
+TEST_CASE("Gradients with other color and position types")
+{
+    auto rng = std::default_random_engine{37};
+    for (const size_t marks_count : std::vector<size_t>{0, 1, 2, 3, 30})
+    {
+        auto gradient = random_gradient(marks_count, rng);
+        for (const auto interpolation : {ImGG::Interpolation::Linear, ImGG::Interpolation::Constant})
+        {
+            gradient.interpolation_mode() = interpolation;
+            const auto gradient_float     = ImGG::TypedGradient<ImGG::ColorRGBA>{gradient};
+            const auto gradient_double    = ImGG::GradientRGBAd{gradient};
+            const auto gradient_rgba8     = ImGG::GradientRGBA8{gradient};
+            for (const float position : positions_to_test(gradient, rng))
+            {
+                const auto expected = gradient.at(ImGG::RelativePosition{position});
+                CHECK(is_approx_same_color(gradient_float.at(position), expected));
+
+                const auto color_double = gradient_double.at(position);
+                CHECK(color_double.r == doctest::Approx(expected.x));
+                CHECK(color_double.g == doctest::Approx(expected.y));
+                CHECK(color_double.b == doctest::Approx(expected.z));
+                CHECK(color_double.a == doctest::Approx(expected.w));
+
+                // The 8-bit gradient interpolates between rounded colors, so it can be off by one
+                const auto color_rgba8    = gradient_rgba8.at(position);
+                const auto expected_rgba8 = ImGui::ColorConvertFloat4ToU32(expected);
+                CHECK(std::abs(static_cast<int>(color_rgba8.r) - static_cast<int>((expected_rgba8 >> IM_COL32_R_SHIFT) & 0xFF)) <= 1);
+                CHECK(std::abs(static_cast<int>(color_rgba8.g) - static_cast<int>((expected_rgba8 >> IM_COL32_G_SHIFT) & 0xFF)) <= 1);
+                CHECK(std::abs(static_cast<int>(color_rgba8.b) - static_cast<int>((expected_rgba8 >> IM_COL32_B_SHIFT) & 0xFF)) <= 1);
+                CHECK(std::abs(static_cast<int>(color_rgba8.a) - static_cast<int>((expected_rgba8 >> IM_COL32_A_SHIFT) & 0xFF)) <= 1);
+            }
+            CHECK(is_approx_same_color(gradient_float.at(-0.25f, ImGG::WrapMode::MirrorRepeat), gradient.at(ImGG::RelativePosition{-0.25f, ImGG::WrapMode::MirrorRepeat})));
+        }
+    }
+
+    SUBCASE("Building from marks")
+    {
+        const auto gradient = ImGG::GradientRGBA8{
+            {{1.f, ImGG::ColorRGBA8{255, 255, 255, 255}}, {0.f, ImGG::ColorRGBA8{0, 0, 0, 255}}},
+            ImGG::Interpolation::Linear,
+        };
+        CHECK(gradient.at(0.5f) == ImGG::ColorRGBA8{128, 128, 128, 255});
+        CHECK(gradient.at(0.25f) == ImGG::ColorRGBA8{64, 64, 64, 255});
+        CHECK(gradient.at(1.5f, ImGG::WrapMode::Repeat) == ImGG::ColorRGBA8{128, 128, 128, 255});
+    }
+
+    SUBCASE("Unsupported features")
+    {
+        auto gradient = ImGG::Gradient{};
+        CHECK(ImGG::GradientRGBA8::can_represent(gradient));
+
+        gradient.interpolation_mode() = ImGG::Interpolation::Cubic;
+        CHECK(!ImGG::GradientRGBA8::can_represent(gradient));
+        gradient.interpolation_mode() = ImGG::Interpolation::Constant;
+        CHECK(ImGG::GradientRGBA8::can_represent(gradient));
+
+        gradient.color_space() = ImGG::ColorSpace::OKLab;
+        CHECK(!ImGG::GradientRGBA8::can_represent(gradient));
+        gradient.color_space() = ImGG::ColorSpace::sRGB;
+
+        gradient.find(gradient.id_of(gradient.get_marks().front()))->midpoint = 0.25f;
+        CHECK(!ImGG::GradientRGBAd::can_represent(gradient));
+    }
+}
+
+TEST_CASE("Fixed point gradient")
+{
+    SUBCASE("Same colors as the floating point gradient, up to rounding")
+    {
+        auto rng = std::default_random_engine{41};
+        for (const size_t marks_count : std::vector<size_t>{0, 1, 2, 3, 30})
+        {
+            // Put the marks exactly on fixed point positions, so that both gradients have the same marks
+            auto marks = random_gradient(marks_count, rng).get_marks();
+            for (auto& mark : marks)
+                mark.position = ImGG::RelativePosition{static_cast<float>(ImGG::FixedPointGradient::to_fixed_point(mark.position.get())) / 65535.f};
+            auto gradient = ImGG::Gradient{marks};
+            for (const auto interpolation : {ImGG::Interpolation::Linear, ImGG::Interpolation::Constant})
+            {
+                gradient.interpolation_mode() = interpolation;
+                const auto fixed_point        = ImGG::FixedPointGradient{gradient};
+                const auto reference          = ImGG::GradientRGBA8{gradient};
+                for (uint32_t position = 0; position <= 65535; position += 7)
+                {
+                    const auto color    = fixed_point.at(static_cast<ImGG::FixedPointPosition>(position));
+                    const auto expected = reference.at(static_cast<float>(position) / 65535.f);
+                    CHECK(std::abs(color.r - expected.r) <= 1);
+                    CHECK(std::abs(color.g - expected.g) <= 1);
+                    CHECK(std::abs(color.b - expected.b) <= 1);
+                    CHECK(std::abs(color.a - expected.a) <= 1);
+                }
+            }
+        }
+    }
+
+    SUBCASE("The colors never change")
+    {
+        const auto gradient = ImGG::FixedPointGradient{
+            {{0, {0, 0, 0, 255}}, {20000, {255, 10, 30, 255}}, {20000, {1, 2, 3, 4}}, {41234, {12, 240, 100, 128}}, {65535, {255, 255, 255, 255}}},
+            ImGG::Interpolation::Linear,
+        };
+        CHECK(gradient.at(32768) == ImGG::ColorRGBA8{109, 148, 72, 179});
+        std::vector<ImGG::FixedPointPosition> positions(65536);
+        for (size_t i = 0; i < positions.size(); ++i)
+            positions[i] = static_cast<ImGG::FixedPointPosition>(i);
+        std::vector<ImGG::ColorRGBA8> colors(positions.size());
+        gradient.sample(positions.data(), colors.data(), positions.size());
+        uint32_t hash = 2166136261u; // FNV-1a
+        for (const auto& color : colors)
+        {
+            for (const uint8_t channel : {color.r, color.g, color.b, color.a})
+                hash = (hash ^ channel) * 16777619u;
+        }
+        CHECK(hash == 576220923u);
+    }
+
+    SUBCASE("Unsupported features")
+    {
+        auto gradient = ImGG::Gradient{};
+        CHECK(ImGG::FixedPointGradient::can_represent(gradient));
+        gradient.interpolation_mode() = ImGG::Interpolation::Cubic;
+        CHECK(!ImGG::FixedPointGradient::can_represent(gradient));
+        gradient.interpolation_mode() = ImGG::Interpolation::Linear;
+        gradient.color_space()        = ImGG::ColorSpace::LinearRGB;
+        CHECK(!ImGG::FixedPointGradient::can_represent(gradient));
+        gradient.color_space() = ImGG::ColorSpace::sRGB;
+        gradient.find(gradient.id_of(gradient.get_marks().back()))->midpoint = 0.75f;
+        CHECK(!ImGG::FixedPointGradient::can_represent(gradient));
+    }
+}
+
+TEST_CASE("Compact gradient")
+{
+    auto rng          = std::default_random_engine{59};
+    auto distribution = std::uniform_real_distribution<float>{0.f, 1.f};
+    CHECK(sizeof(ImGG::CompactMark) == 8);
+
+    auto gradients = std::vector<ImGG::Gradient>{};
+    for (const size_t marks_count : std::vector<size_t>{0, 1, 2, 3, 30})
+        gradients.push_back(random_gradient(marks_count, rng));
+    gradients.back().add_mark({ImGG::RelativePosition{0.5f}, ImGG::ColorRGBA{1.f, 0.f, 0.f, 1.f}}); // Marks sharing the same position
+    gradients.back().add_mark({ImGG::RelativePosition{0.5f}, ImGG::ColorRGBA{0.f, 1.f, 0.f, 1.f}});
+    for (auto& gradient : gradients)
+    {
+        for (const auto& mark : gradient.get_marks())
+        {
+            if (distribution(rng) < 0.5f)
+                gradient.find(gradient.id_of(mark))->midpoint = distribution(rng);
+        }
+    }
+
+    for (const auto color_format : {ImGG::CompactColorFormat::RGBA8, ImGG::CompactColorFormat::RGB10A2})
+    {
+        const float color_precision = color_format == ImGG::CompactColorFormat::RGBA8 ? 0.5f / 255.f : 0.5f / 1023.f;
+        const float alpha_precision = color_format == ImGG::CompactColorFormat::RGBA8 ? 0.5f / 255.f : 0.5f / 3.f;
+        for (auto gradient : gradients)
+        {
+            for (const auto interpolation : {ImGG::Interpolation::Linear, ImGG::Interpolation::Constant, ImGG::Interpolation::Cubic})
+            {
+                for (const auto color_space : {ImGG::ColorSpace::sRGB, ImGG::ColorSpace::OKLab})
+                {
+                    gradient.interpolation_mode() = interpolation;
+                    gradient.color_space()        = color_space;
+                    const auto compact            = ImGG::CompactGradient{gradient, color_format};
+
+                    // Converting back and forth doesn't lose anything more
+                    const auto converted = compact.to_gradient();
+                    CHECK(ImGG::CompactGradient{converted, color_format} == compact);
+                    CHECK(converted.interpolation_mode() == interpolation);
+                    CHECK(converted.color_space() == color_space);
+
+                    // The marks are rounded to the closest representable values
+                    REQUIRE(converted.get_marks().size() == gradient.get_marks().size());
+                    for (size_t i = 0; i < gradient.get_marks().size(); ++i)
+                    {
+                        const auto& original = gradient.get_marks()[i];
+                        const auto& rounded  = converted.get_marks()[i];
+                        CHECK(std::abs(rounded.position.get() - original.position.get()) <= 0.5f / 65535.f + 1e-7f);
+                        CHECK(std::abs(rounded.midpoint - original.midpoint) <= 0.5f / 65534.f + 1e-7f);
+                        CHECK(std::abs(rounded.color.x - original.color.x) <= color_precision + 1e-6f);
+                        CHECK(std::abs(rounded.color.y - original.color.y) <= color_precision + 1e-6f);
+                        CHECK(std::abs(rounded.color.z - original.color.z) <= color_precision + 1e-6f);
+                        CHECK(std::abs(rounded.color.w - original.color.w) <= alpha_precision + 1e-6f);
+                    }
+
+                    // Sampling the compact form gives the same colors as the converted gradient
+                    for (const float position : positions_to_test(converted, rng))
+                        CHECK(is_same_color(compact.at(ImGG::RelativePosition{position}), converted.at(ImGG::RelativePosition{position})));
+                }
+            }
+        }
+    }
+
+    SUBCASE("0.5 is an exact midpoint")
+    {
+        const auto compact = ImGG::CompactGradient{ImGG::Gradient{}};
+        CHECK(compact.mark(0).midpoint == 0.5f);
+        CHECK(compact.mark(1).midpoint == 0.5f);
+        CHECK(compact.to_gradient() == ImGG::Gradient{});
+    }
+}
+
+TEST_CASE("Half floats")
+{
+    SUBCASE("Conversions")
+    {
+        CHECK(ImGG::internal::float_to_half(0.f) == 0x0000);
+        CHECK(ImGG::internal::float_to_half(-0.f) == 0x8000);
+        CHECK(ImGG::internal::float_to_half(1.f) == 0x3C00);
+        CHECK(ImGG::internal::float_to_half(-2.f) == 0xC000);
+        CHECK(ImGG::internal::float_to_half(0.1f) == 0x2E66);
+        CHECK(ImGG::internal::float_to_half(65504.f) == 0x7BFF);
+        CHECK(ImGG::internal::float_to_half(65519.f) == 0x7BFF);
+        CHECK(ImGG::internal::float_to_half(65520.f) == 0x7C00);
+        CHECK(ImGG::internal::float_to_half(std::numeric_limits<float>::infinity()) == 0x7C00);
+        CHECK(ImGG::internal::float_to_half(std::ldexp(1.f, -24)) == 0x0001);
+        CHECK(ImGG::internal::float_to_half(std::ldexp(1.f, -25)) == 0x0000); // Ties round to even
+        CHECK(ImGG::internal::float_to_half(std::ldexp(3.f, -25)) == 0x0002);
+        CHECK((ImGG::internal::float_to_half(std::numeric_limits<float>::quiet_NaN()) & 0x7FFF) > 0x7C00);
+
+        for (uint32_t half = 0; half <= 0xFFFF; ++half)
+        {
+            if ((half & 0x7C00) == 0x7C00 && (half & 0x3FF) != 0)
+                continue; // NaNs don't keep their payload
+            CHECK(ImGG::internal::float_to_half(ImGG::internal::half_to_float(static_cast<uint16_t>(half))) == half);
+        }
+    }
+
+    SUBCASE("All the conversion methods give the same results")
+    {
+        auto                  rng = std::default_random_engine{43};
+        std::vector<float>    floats(100003);
+        std::vector<uint16_t> expected(floats.size());
+        std::vector<uint16_t> halves(floats.size());
+        for (auto& value : floats)
+        {
+            const auto bits = static_cast<uint32_t>(rng());
+            std::memcpy(&value, &bits, sizeof(value));
+        }
+        floats[0] = 65520.f;
+        floats[1] = std::ldexp(1.f, -25);
+        ImGG::internal::floats_to_halves_scalar(floats.data(), expected.data(), floats.size());
+        ImGG::internal::floats_to_halves(floats.data(), halves.data(), floats.size());
+        CHECK(halves == expected);
+    }
+
+    SUBCASE("Baking")
+    {
+        auto rng = std::default_random_engine{47};
+        for (const size_t marks_count : std::vector<size_t>{0, 1, 2, 10})
+        {
+            const auto compiled = random_gradient(marks_count, rng).compile();
+            for (const size_t size : std::vector<size_t>{1, 255, 256, 257, 1000})
+            {
+                std::vector<ImGG::ColorRGBA> colors(size);
+                std::vector<uint16_t>        halves(4 * size);
+                compiled.bake(colors.data(), size);
+                compiled.bake_rgba16f(halves.data(), size);
+                for (size_t i = 0; i < size; ++i)
+                {
+                    CHECK(halves[4 * i + 0] == ImGG::internal::float_to_half(colors[i].x));
+                    CHECK(halves[4 * i + 1] == ImGG::internal::float_to_half(colors[i].y));
+                    CHECK(halves[4 * i + 2] == ImGG::internal::float_to_half(colors[i].z));
+                    CHECK(halves[4 * i + 3] == ImGG::internal::float_to_half(colors[i].w));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Interpolation color spaces")
+{
+    const auto is_close = [](const ImGG::ColorRGBA& a, const ImGG::ColorRGBA& b) {
+        return std::abs(a.x - b.x) < 0.0001f
+               && std::abs(a.y - b.y) < 0.0001f
+               && std::abs(a.z - b.z) < 0.0001f
+               && std::abs(a.w - b.w) < 0.0001f;
+    };
+
+    SUBCASE("Conversions")
+    {
+        CHECK(is_close(ImGG::internal::srgb_to_linear_rgb({0.5f, 0.f, 1.f, 0.3f}), {0.214041f, 0.f, 1.f, 0.3f}));
+        CHECK(is_close(ImGG::internal::srgb_to_oklab({1.f, 1.f, 1.f, 1.f}), {1.f, 0.f, 0.f, 1.f}));
+        CHECK(is_close(ImGG::internal::srgb_to_oklab({1.f, 0.f, 0.f, 1.f}), {0.627955f, 0.224863f, 0.125846f, 1.f}));
+
+        auto rng          = std::default_random_engine{53};
+        auto distribution = std::uniform_real_distribution<float>{-0.2f, 1.2f}; // A bit outside of the [0, 1] range, like HDR colors
+        for (int i = 0; i < 1000; ++i)
+        {
+            const auto color = ImGG::ColorRGBA{distribution(rng), distribution(rng), distribution(rng), distribution(rng)};
+            for (const auto color_space : {ImGG::ColorSpace::sRGB, ImGG::ColorSpace::LinearRGB, ImGG::ColorSpace::OKLab})
+                CHECK(is_close(ImGG::internal::from_color_space(ImGG::internal::to_color_space(color, color_space), color_space), color));
+        }
+    }
+
+    SUBCASE("Interpolating the amount of light")
+    {
+        auto gradient          = ImGG::Gradient{};
+        gradient.color_space() = ImGG::ColorSpace::LinearRGB;
+        const auto half_light  = ImGG::ColorRGBA{0.735357f, 0.735357f, 0.735357f, 1.f};
+        CHECK(is_close(gradient.at(ImGG::RelativePosition{0.5f}), half_light));
+        CHECK(is_close(gradient.compile().at(ImGG::RelativePosition{0.5f}), half_light));
+        CHECK(is_close(gradient.compile().average(0.f, 1.f, ImGG::WrapMode::Clamp), half_light));
+        CHECK(is_same_color(ImGG::Gradient{gradient}.at(ImGG::RelativePosition{0.5f}), gradient.at(ImGG::RelativePosition{0.5f})));
+    }
+
+    SUBCASE("Constant interpolation keeps the colors of the marks")
+    {
+        auto rng                      = std::default_random_engine{59};
+        auto gradient                 = random_gradient(10, rng);
+        gradient.interpolation_mode() = ImGG::Interpolation::Constant;
+        gradient.color_space()        = ImGG::ColorSpace::OKLab;
+        for (const auto& mark : gradient.get_marks())
+            CHECK(is_same_color(gradient.at(ImGG::RelativePosition{std::nextafter(mark.position.get(), 0.f)}), mark.color));
+    }
+
+    SUBCASE("The compiled gradient gives the same colors as the gradient")
+    {
+        auto rng = std::default_random_engine{61};
+        for (const size_t marks_count : std::vector<size_t>{0, 1, 2, 20})
+        {
+            auto       gradient  = random_gradient(marks_count, rng);
+            const auto positions = positions_to_test(gradient, rng);
+            for (const auto color_space : {ImGG::ColorSpace::LinearRGB, ImGG::ColorSpace::OKLab})
+            {
+                for (const auto interpolation : {ImGG::Interpolation::Linear, ImGG::Interpolation::Constant})
+                {
+                    gradient.color_space()        = color_space;
+                    gradient.interpolation_mode() = interpolation;
+                    const auto compiled           = gradient.compile();
+                    auto       cursor             = ImGG::GradientCursor{compiled};
+
+                    std::vector<ImGG::ColorRGBA> colors(positions.size());
+                    compiled.sample(positions.data(), colors.data(), positions.size(), ImGG::WrapMode::Clamp);
+                    for (size_t i = 0; i < positions.size(); ++i)
+                    {
+                        const auto expected = gradient.at(ImGG::RelativePosition{positions[i]});
+                        CHECK(is_close(compiled.at(ImGG::RelativePosition{positions[i]}), expected));
+                        CHECK(is_close(cursor.at(ImGG::RelativePosition{positions[i]}), expected));
+                        CHECK(is_close(colors[i], expected));
+                    }
+
+                    std::vector<ImGG::ColorRGBA> lut(300);
+                    compiled.bake(lut.data(), lut.size());
+                    for (size_t i = 0; i < lut.size(); ++i)
+                        CHECK(is_close(lut[i], gradient.at(ImGG::RelativePosition{ImGG::internal::texel_center(i, lut.size())})));
+                }
+            }
+        }
+    }
+
+    SUBCASE("Inverse colormap")
+    {
+        auto gradient          = ImGG::Gradient{std::list<ImGG::Mark>{
+            ImGG::Mark{ImGG::RelativePosition{0.f}, ImGG::ColorRGBA{0.f, 0.f, 1.f, 1.f}},
+            ImGG::Mark{ImGG::RelativePosition{1.f}, ImGG::ColorRGBA{1.f, 1.f, 0.f, 1.f}},
+        }};
+        gradient.color_space() = ImGG::ColorSpace::OKLab;
+        const auto compiled    = gradient.compile();
+        const auto inverse     = ImGG::InverseColormap{compiled};
+        for (const float position : {0.1f, 0.3f, 0.77f})
+        {
+            const auto result = inverse.find(compiled.at(ImGG::RelativePosition{position}));
+            CHECK(result.position == doctest::Approx(position).epsilon(0.001));
+            CHECK(result.distance < 0.0001f);
+        }
+    }
+
+    SUBCASE("The LUT size takes the curvature into account")
+    {
+        auto gradient          = ImGG::Gradient{};
+        gradient.color_space() = ImGG::ColorSpace::LinearRGB;
+        const auto compiled    = gradient.compile();
+        const auto bake_size   = ImGG::choose_bake_size(compiled, 1.f / 255.f);
+        std::vector<ImGG::ColorRGBA> lut(bake_size.size);
+        compiled.bake(lut.data(), lut.size());
+        for (size_t i = 0; i + 1 < lut.size(); ++i)
+        {
+            const auto filtered = ImLerp(lut[i], lut[i + 1], 0.5f);
+            const auto expected = compiled.at(ImGG::RelativePosition{static_cast<float>(i + 1) / static_cast<float>(lut.size())});
+            CHECK(std::abs(filtered.x - expected.x) <= bake_size.estimated_error + 0.0001f);
+        }
+    }
+}
+
+TEST_CASE("Cubic interpolation")
+{
+    SUBCASE("It is smooth and goes through the marks")
+    {
+        auto gradient = ImGG::Gradient{std::list<ImGG::Mark>{
+            ImGG::Mark{ImGG::RelativePosition{0.f}, ImGG::ColorRGBA{0.f, 0.f, 0.f, 1.f}},
+            ImGG::Mark{ImGG::RelativePosition{0.5f}, ImGG::ColorRGBA{1.f, 1.f, 1.f, 1.f}},
+            ImGG::Mark{ImGG::RelativePosition{1.f}, ImGG::ColorRGBA{0.f, 0.f, 0.f, 1.f}},
+        }};
+        gradient.interpolation_mode() = ImGG::Interpolation::Cubic;
+        // The white mark is a maximum, so the curve is flat there, and it eases into it
+        CHECK(is_approx_same_color(gradient.at(ImGG::RelativePosition{0.25f}), ImGG::ColorRGBA{0.625f, 0.625f, 0.625f, 1.f}));
+        CHECK(is_approx_same_color(gradient.at(ImGG::RelativePosition{0.75f}), ImGG::ColorRGBA{0.625f, 0.625f, 0.625f, 1.f}));
+        CHECK(is_approx_same_color(gradient.at(ImGG::RelativePosition{std::nextafter(0.5f, 0.f)}), ImGG::ColorRGBA{1.f, 1.f, 1.f, 1.f}));
+        CHECK(is_approx_same_color(gradient.at(ImGG::RelativePosition{std::nextafter(0.5f, 1.f)}), ImGG::ColorRGBA{1.f, 1.f, 1.f, 1.f}));
+    }
+
+    SUBCASE("With two marks it is a straight line")
+    {
+        auto gradient                 = ImGG::Gradient{};
+        gradient.interpolation_mode() = ImGG::Interpolation::Cubic;
+        for (const float position : {0.1f, 0.5f, 0.9f})
+            CHECK(is_approx_same_color(gradient.at(ImGG::RelativePosition{position}), ImGG::ColorRGBA{position, position, position, 1.f}));
+    }
+
+    SUBCASE("It never overshoots")
+    {
+        auto rng                      = std::default_random_engine{67};
+        auto gradient                 = random_gradient(30, rng);
+        gradient.interpolation_mode() = ImGG::Interpolation::Cubic;
+        const auto compiled           = gradient.compile();
+        const auto marks              = std::vector<ImGG::Mark>{gradient.get_marks().begin(), gradient.get_marks().end()};
+        const auto is_between         = [](float value, float a, float b) {
+            return value >= std::min(a, b) - 0.00001f && value <= std::max(a, b) + 0.00001f;
+        };
+        for (size_t i = 1; i < marks.size(); ++i)
+        {
+            for (int step = 1; step < 20; ++step)
+            {
+                const auto position = ImGG::RelativePosition{ImLerp(marks[i - 1].position.get(), marks[i].position.get(), static_cast<float>(step) / 20.f)};
+                const auto color    = compiled.at(position);
+                CHECK(is_between(color.x, marks[i - 1].color.x, marks[i].color.x));
+                CHECK(is_between(color.y, marks[i - 1].color.y, marks[i].color.y));
+                CHECK(is_between(color.z, marks[i - 1].color.z, marks[i].color.z));
+                CHECK(is_between(color.w, marks[i - 1].color.w, marks[i].color.w));
+            }
+        }
+    }
+}
+
+TEST_CASE("Midpoints")
+{
+    SUBCASE("The color is halfway between the marks on the midpoint")
+    {
+        auto gradient = ImGG::Gradient{std::list<ImGG::Mark>{
+            ImGG::Mark{ImGG::RelativePosition{0.f}, ImGG::ColorRGBA{0.f, 0.f, 0.f, 1.f}},
+            ImGG::Mark{ImGG::RelativePosition{1.f}, ImGG::ColorRGBA{1.f, 1.f, 1.f, 1.f}, 0.25f},
+        }};
+        const auto compiled = gradient.compile();
+        CHECK(is_approx_same_color(gradient.at(ImGG::RelativePosition{0.25f}), ImGG::ColorRGBA{0.5f, 0.5f, 0.5f, 1.f}));
+        CHECK(is_approx_same_color(compiled.at(ImGG::RelativePosition{0.25f}), ImGG::ColorRGBA{0.5f, 0.5f, 0.5f, 1.f}));
+        CHECK(is_approx_same_color(compiled.at(ImGG::RelativePosition{0.5f}), ImGG::ColorRGBA{0.75f, 0.75f, 0.75f, 1.f}));
+    }
+
+    SUBCASE("A midpoint of 0.5 doesn't change anything")
+    {
+        const auto bias = ImGG::internal::MidpointBias{0.5f};
+        for (const float t : {0.f, 0.1f, 0.3333f, 0.5f, 0.9f, 1.f})
+            CHECK(bias(t) == t);
+    }
+
+    auto rng          = std::default_random_engine{73};
+    auto distribution = std::uniform_real_distribution<float>{0.f, 1.f};
+    auto gradient     = random_gradient(20, rng);
+    for (auto mark_iterator = gradient.get_marks().begin(); mark_iterator != gradient.get_marks().end(); ++mark_iterator)
+        gradient.find(gradient.id_of(*mark_iterator))->midpoint = distribution(rng);
+
+    SUBCASE("All the ways of sampling agree")
+    {
+        for (const auto interpolation : {ImGG::Interpolation::Linear, ImGG::Interpolation::Cubic})
+        {
+            gradient.interpolation_mode() = interpolation;
+            const auto compiled           = gradient.compile();
+            auto       positions          = positions_to_test(gradient, rng);
+            for (const float position : positions)
+                CHECK(is_approx_same_color(compiled.at(ImGG::RelativePosition{position}), gradient.at(ImGG::RelativePosition{position})));
+
+            for (const auto instruction_set : {ImGG::internal::InstructionSet::SSE2, ImGG::internal::InstructionSet::AVX2, ImGG::internal::InstructionSet::NEON})
+            {
+                if (!ImGG::internal::is_supported(instruction_set))
+                    continue;
+                std::vector<ImGG::ColorRGBA> colors(positions.size());
+                ImGG::internal::sample_kernel(instruction_set)(compiled.sampling_data(), positions.data(), colors.data(), positions.size(), ImGG::WrapMode::Clamp);
+                for (size_t i = 0; i < positions.size(); ++i)
+                    CHECK(is_same_color(colors[i], compiled.at(ImGG::RelativePosition{positions[i]})));
+            }
+        }
+    }
+
+    SUBCASE("Average color and inverse lookup")
+    {
+        const auto compiled = gradient.compile();
+
+        static constexpr int samples_count = 20000;
+        auto                 expected      = ImGG::ColorRGBA{0.f, 0.f, 0.f, 0.f};
+        for (int sample = 0; sample < samples_count; ++sample)
+        {
+            const auto color = compiled.at(ImGG::RelativePosition{(static_cast<float>(sample) + 0.5f) / samples_count});
+            expected.x += color.x / samples_count;
+            expected.y += color.y / samples_count;
+            expected.z += color.z / samples_count;
+            expected.w += color.w / samples_count;
+        }
+        const auto average = compiled.average(0.f, 1.f, ImGG::WrapMode::Clamp);
+        CHECK(std::abs(average.x - expected.x) < 0.002f);
+        CHECK(std::abs(average.y - expected.y) < 0.002f);
+        CHECK(std::abs(average.z - expected.z) < 0.002f);
+        CHECK(std::abs(average.w - expected.w) < 0.002f);
+
+        const auto inverse = ImGG::InverseColormap{compiled};
+        for (int i = 0; i < 200; ++i)
+        {
+            const auto color  = compiled.at(ImGG::RelativePosition{distribution(rng)});
+            const auto result = inverse.find(color);
+            CHECK(result.distance < 0.0001f);
+            CHECK(is_approx_same_color(compiled.at(ImGG::RelativePosition{result.position}), color));
+        }
+    }
+}
+
 TEST_CASE("Wrap modes")
 {
     SUBCASE("clamp_position() when position in the range [0,1]")